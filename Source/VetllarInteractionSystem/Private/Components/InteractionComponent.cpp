@@ -4,22 +4,93 @@
 
 //Engine
 #include "Camera/CameraComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SphereComponent.h"
 #if WITH_EDITOR
 #include "Engine.h"
 #endif //WITH_EDITOR
+#include "Engine/StaticMesh.h"
 #include "Engine/World.h"
+#include "GameplayTagAssetInterface.h"
+#include "GameplayTagContainer.h"
+#include "Camera/PlayerCameraManager.h"
 #include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Net/UnrealNetwork.h"
 #include "UObject/UObjectThreadContext.h"
 
 //Vetllar Interaction
 #include "Components/InteractiveComponent.h"
+#include "FocusDetectors.h"
+#include "InteractionSettings.h"
+#include "InteractionStats.h"
+#include "InteractionSubsystem.h"
 #include "InteractiveConfig.h"
 #include "InteractiveInterface.h"
 
 DEFINE_LOG_CATEGORY(LogInteraction);
 
+DECLARE_CYCLE_STAT(TEXT("Focus Trace (Physics)"), STAT_VetInteraction_PhysicsFocusTrace, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Focus Trace (Spatial Index)"), STAT_VetInteraction_SpatialIndexFocusTrace, STATGROUP_VetInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Focus Traces Executed"), STAT_VetInteraction_ExecutedTraces, STATGROUP_VetInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Focus Traces Skipped"), STAT_VetInteraction_SkippedTraces, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Validate Client Focus"), STAT_VetInteraction_ValidateClientFocus, STATGROUP_VetInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Requests Coalesced"), STAT_VetInteraction_CoalescedRequests, STATGROUP_VetInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Requests Throttled"), STAT_VetInteraction_ThrottledRequests, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Score Focus Candidates"), STAT_VetInteraction_ScoreFocusCandidates, STATGROUP_VetInteraction);
+
+namespace VetInteractionComponent
+{
+	//Scores 4 candidates at a time, lower is better. Offsets are relative to the view location and padded to a multiple of 4.
+	//The distance to each candidate grows with its angle to the view direction, and its priority is subtracted from it.
+	void ScoreFocusCandidates(const FVector3f& InViewDirection, float InAngleWeight, const float* InOffsetsX, const float* InOffsetsY, const float* InOffsetsZ, const float* InPriorities, float* OutScores, int32 InPaddedNum)
+	{
+		const VectorRegister4Float DirectionX = VectorSetFloat1(InViewDirection.X);
+		const VectorRegister4Float DirectionY = VectorSetFloat1(InViewDirection.Y);
+		const VectorRegister4Float DirectionZ = VectorSetFloat1(InViewDirection.Z);
+		const VectorRegister4Float AngleWeight = VectorSetFloat1(InAngleWeight);
+		const VectorRegister4Float MinDistanceSquared = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+		const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+
+		for (int32 Index = 0; Index < InPaddedNum; Index += 4)
+		{
+			const VectorRegister4Float OffsetX = VectorLoad(InOffsetsX + Index);
+			const VectorRegister4Float OffsetY = VectorLoad(InOffsetsY + Index);
+			const VectorRegister4Float OffsetZ = VectorLoad(InOffsetsZ + Index);
+
+			const VectorRegister4Float DistanceSquared = VectorMax(VectorMultiplyAdd(OffsetX, OffsetX, VectorMultiplyAdd(OffsetY, OffsetY, VectorMultiply(OffsetZ, OffsetZ))), MinDistanceSquared);
+			const VectorRegister4Float InvDistance = VectorReciprocalSqrt(DistanceSquared);
+			const VectorRegister4Float Distance = VectorMultiply(DistanceSquared, InvDistance);
+			const VectorRegister4Float Cosine = VectorMultiply(VectorMultiplyAdd(OffsetX, DirectionX, VectorMultiplyAdd(OffsetY, DirectionY, VectorMultiply(OffsetZ, DirectionZ))), InvDistance);
+
+			const VectorRegister4Float AngleFactor = VectorMultiplyAdd(VectorSubtract(One, Cosine), AngleWeight, One);
+			const VectorRegister4Float Score = VectorSubtract(VectorMultiply(Distance, AngleFactor), VectorLoad(InPriorities + Index));
+			VectorStore(Score, OutScores + Index);
+		}
+	}
+
+	//Calls the functor with the detector cast to its final class so the built in detectors are called without virtual dispatch.
+	template<typename TFunc>
+	auto VisitFocusDetector(const UVetFocusDetector& InDetector, TFunc&& InFunc)
+	{
+		switch (InDetector.GetType())
+		{
+		case EVetFocusDetectorType::SphereSweep:
+			return InFunc(static_cast<const UVetFocusDetector_SphereSweep&>(InDetector));
+		case EVetFocusDetectorType::ViewCone:
+			return InFunc(static_cast<const UVetFocusDetector_ViewCone&>(InDetector));
+		case EVetFocusDetectorType::Cursor:
+			return InFunc(static_cast<const UVetFocusDetector_Cursor&>(InDetector));
+		case EVetFocusDetectorType::Overlap:
+			return InFunc(static_cast<const UVetFocusDetector_Overlap&>(InDetector));
+		default:
+			return InFunc(InDetector);
+		}
+	}
+}
+
 UVetInteractionComponent::UVetInteractionComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
@@ -33,65 +104,179 @@ void UVetInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickTyp
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	UpdateFocus();
+}
+
+void UVetInteractionComponent::UpdateFocus()
+{
+	if (PrepareFocusUpdate())
+	{
+		TraceForInteractives();
+	}
+}
+
+bool UVetInteractionComponent::PrepareFocusUpdate()
+{
 	//Do not search for new interactive objects if we are already interacting with something
-	if (InteractionState.IsInteracting())
+	if (IsInteractingOrPredicting())
 	{
-		return;
+		return false;
 	}
 
-	TraceForInteractives();
+	if (!ShouldTraceForInteractives())
+	{
+		++SkippedTraceCount;
+		INC_DWORD_STAT(STAT_VetInteraction_SkippedTraces);
+		return false;
+	}
+
+	++ExecutedTraceCount;
+	INC_DWORD_STAT(STAT_VetInteraction_ExecutedTraces);
+	return true;
+}
+
+bool UVetInteractionComponent::CanBatchFocusUpdate() const
+{
+	return FocusDetector == nullptr
+		&& TraceType == EVetInteractionTraceType::SphereTrace_FromOwner
+		&& !bUseSpatialIndex
+		&& !bUseAsyncTraces;
 }
 
 void UVetInteractionComponent::StartInteraction()
 {
 	//We cannot start a new interaction if we are already interacting with something
-	if (InteractionState.IsInteracting())
+	if (IsInteractingOrPredicting())
 	{
 		return;
 	}
 	
-	if (!IsValid(InteractionState.GetFocusedComponent()) || !IVetInteractiveInterface::CanBeInteractedWith_Internal(InteractionState.GetFocusedActor(), this))
+	if (!IsValid(FocusedComponent) || !IVetInteractiveInterface::CanBeInteractedWith_Internal(GetFocusedActor(), this)
+		|| !IsFocusedInstanceAvailable())
 	{
 		return;
 	}
 
 	if (!GetOwner()->HasAuthority())
 	{
-		//Pass in the focused actor in case we predicted it during a trace from cursor (the server can't know the focused actor if tracing from cursor).
+		if (!ShouldSendRequest(PendingStartRequestTime))
+		{
+			return;
+		}
+		bStopAfterStartRequest = false;
 
-		UPrimitiveComponent* ServerFocusedComponent = (TraceType == EVetInteractionTraceType::LineTrace_FromCursor) ? InteractionState.GetFocusedComponent() : nullptr;
-		Server_StartInteraction(ServerFocusedComponent);	
+		//Pass in the focused actor in case we predicted it during a trace from cursor or with client authoritative focus (the server can't know the focused actor then).
+
+		const bool bSendFocus = IsFocusFromLocalPlayer()
+			|| (bClientAuthoritativeFocus && FocusDetector == nullptr && TraceType == EVetInteractionTraceType::SphereTrace_FromOwner);
+		QueuedStartFocusedHandle = bSendFocus ? MakeInteractiveHandle(FocusedComponent).WithInstance(FocusedInstanceIndex) : FVetInteractiveHandle();
+		QueuedStartPredictionKey = bPredictInteractions ? PredictInteractionStart() : 0;
+		bStopQueuedStartRequest = false;
+		if (!QueuedStartRequestHandle.IsValid())
+		{
+			QueuedStartRequestHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UVetInteractionComponent::SendQueuedStartRequest);
+		}
 		return;
 	}
-	
-	if (UVetInteractiveComponent* InteractiveComponent =  IVetInteractiveInterface::GetInteractiveComponent_Internal(InteractionState.GetFocusedActor()))
+
+	StartInteraction_Internal(FocusedComponent, FocusedInstanceIndex, /*InPredictionKey =*/ 0);
+}
+
+bool UVetInteractionComponent::StartInteraction_Internal(UPrimitiveComponent* InComponent, int32 InInstanceIndex, uint8 InPredictionKey)
+{
+	if (InteractionState.IsInteracting()
+		|| !IsValid(InComponent) || !IVetInteractiveInterface::CanBeInteractedWith_Internal(InComponent->GetOwner(), this))
 	{
-		FOnInteractionComplete InteractionCompleteDelegate;
-		InteractionCompleteDelegate.BindUObject(this, &UVetInteractionComponent::OnInteractionCompleted);
+		return false;
+	}
 
-		if (InteractiveComponent->StartInteraction(*this, InteractionCompleteDelegate, InteractionState.GetFocusedComponent()))
-		{
-			//If the interaction is not instant disable ticking to avoid changing focus during the interaction.
-			UVetInteractiveConfig* InteractiveConfig = InteractiveComponent->GetInteractiveConfig();
-			if (InteractiveConfig && InteractiveConfig->InteractionTime > 0.0f)
-			{
-				InteractionState.SetIsInteracting(true);
-				ConditionallySetTickEnabled(/*bInEnabled =*/ false);
-			}
-		}
+	UVetInteractiveComponent* InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(InComponent->GetOwner());
+	if (InteractiveComponent == nullptr)
+	{
+		return false;
+	}
+
+	FOnInteractionComplete InteractionCompleteDelegate;
+	InteractionCompleteDelegate.BindUObject(this, &UVetInteractionComponent::OnInteractionCompleted);
+
+	//Set before starting since instant interactions complete right away
+	const bool bIsFocused = InComponent == FocusedComponent && InInstanceIndex == FocusedInstanceIndex;
+	InteractionState.SetInteractingComponent(InComponent, bIsFocused ? FocusedHandle : MakeInteractiveHandle(InComponent).WithInstance(InInstanceIndex));
+	InteractionState.SetPredictionKey(InPredictionKey);
+
+	if (!InteractiveComponent->StartInteraction(*this, InteractionCompleteDelegate, InComponent, InInstanceIndex))
+	{
+		return false;
+	}
+
+	//If the interaction is not instant disable ticking to avoid changing focus during the interaction.
+	UVetInteractiveConfig* InteractiveConfig = InteractiveComponent->GetInteractiveConfig();
+	if (InteractiveConfig && InteractiveConfig->InteractionTime > 0.0f)
+	{
+		InteractionState.SetIsInteracting(true);
+		MarkInteractionStateDirty();
+		ConditionallySetTickEnabled(/*bInEnabled =*/ false);
+	}
+	return true;
+}
+
+uint8 UVetInteractionComponent::PredictInteractionStart()
+{
+	//Instant interactions are not predicted, there is nothing to show until they complete.
+	UVetInteractiveComponent* const InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(GetFocusedActor());
+	if (InteractiveComponent == nullptr
+		|| InteractiveComponent->GetInteractiveConfig() == nullptr
+		|| InteractiveComponent->GetInteractiveConfig()->InteractionTime <= 0.0f)
+	{
+		return 0;
+	}
+
+	LastPredictionKey = (LastPredictionKey == MAX_uint8) ? 1 : LastPredictionKey + 1;
+	PendingPredictionKey = LastPredictionKey;
+	PredictedInteractingComponent = FocusedComponent;
+
+	InteractiveComponent->StartPredictedInteraction(*this, FocusedComponent, FocusedInstanceIndex);
+	OnInteractionStarted.Broadcast(InteractiveComponent);
+	ConditionallySetTickEnabled(/*bInEnabled =*/ false);
+
+	return PendingPredictionKey;
+}
+
+void UVetInteractionComponent::RollbackPredictedInteraction()
+{
+	UVetInteractiveComponent* const InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(GetInteractingActor_Internal());
+
+	PendingPredictionKey = 0;
+	PredictedInteractingComponent = nullptr;
+
+	if (InteractiveComponent != nullptr)
+	{
+		InteractiveComponent->CancelPredictedInteraction();
+	}
+	OnInteractionEnded.Broadcast(InteractiveComponent, EVetInteractionResult::Cancelled);
+	ConditionallySetTickEnabled(/*bInEnabled =*/ true);
+}
+
+AActor* UVetInteractionComponent::GetInteractingActor_Internal() const
+{
+	if (PendingPredictionKey != 0)
+	{
+		const UPrimitiveComponent* const PredictedComponent = PredictedInteractingComponent.Get();
+		return PredictedComponent ? PredictedComponent->GetOwner() : nullptr;
 	}
+	return InteractionState.GetInteractingActor();
 }
 
 void UVetInteractionComponent::StartTouchInteraction()
 {
 	//Don't even try if an interaction is already taking place
-	if (InteractionState.IsInteracting())
+	if (IsInteractingOrPredicting())
 	{
 		return;
 	}
 
 	//Update any focused actor when touching the screen.
-	if (TraceType == EVetInteractionTraceType::LineTrace_FromCursor
+	if (IsFocusFromLocalPlayer()
 		&& IsLocal())
 	{
 		TraceForInteractives(/*bInFromTouch =*/ true);
@@ -102,19 +287,32 @@ void UVetInteractionComponent::StartTouchInteraction()
 
 void UVetInteractionComponent::StopInteraction()
 {
+	//Released in the same frame it was pressed (e.g: a tap), the stop goes in the start request.
+	if (QueuedStartRequestHandle.IsValid())
+	{
+		INC_DWORD_STAT(STAT_VetInteraction_CoalescedRequests);
+		bStopQueuedStartRequest = true;
+		return;
+	}
+
 	//Can't stop an interaction that is not taking place
-	if (!InteractionState.IsInteracting())
+	if (!IsInteractingOrPredicting())
 	{
+		//Stopped before the server answered, the stop is sent once the interaction starts.
+		if (PendingStartRequestTime >= 0.0)
+		{
+			bStopAfterStartRequest = true;
+		}
 		return;
 	}
 
-	auto* const FocusedInteractive = Cast<IVetInteractiveInterface>(InteractionState.GetFocusedActor());
+	auto* const FocusedInteractive = Cast<IVetInteractiveInterface>(GetInteractingActor_Internal());
 	if (FocusedInteractive == nullptr)
 	{
 		return;
 	}
 
-	UVetInteractiveComponent* InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(InteractionState.GetFocusedActor());
+	UVetInteractiveComponent* InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(GetInteractingActor_Internal());
 	if (InteractiveComponent == nullptr)
 	{
 		return;
@@ -133,7 +331,10 @@ void UVetInteractionComponent::StopInteraction()
 
 	if (!GetOwner()->HasAuthority())
 	{
-		Server_StopInteraction();
+		if (ShouldSendRequest(PendingStopRequestTime))
+		{
+			Server_StopInteraction();
+		}
 		return;
 	}
 
@@ -145,12 +346,26 @@ void UVetInteractionComponent::StopInteraction()
 
 	InteractionState.SetIsInteracting(false);
 	InteractionState.SetResult(EVetInteractionResult::Cancelled);
+	MarkInteractionStateDirty();
 
 	InteractiveComponent->CancelInteraction();
 
 	OnInteractionEnded_Internal();
 }
 
+void UVetInteractionComponent::GetViewPoint(FVector& OutLocation, FVector& OutDirection) const
+{
+	if (const UCameraComponent* const CameraComponent = ViewCamera.Get())
+	{
+		OutLocation = CameraComponent->GetComponentLocation();
+		OutDirection = CameraComponent->GetForwardVector();
+		return;
+	}
+
+	OutLocation = GetOwner()->GetActorLocation();
+	OutDirection = GetOwner()->GetActorForwardVector();
+}
+
 bool UVetInteractionComponent::IsLocallyControlled() const
 {
 	AActor* const OwningActor = GetOwner();
@@ -170,6 +385,60 @@ bool UVetInteractionComponent::IsLocallyControlled() const
 	return false;
 }
 
+void UVetInteractionComponent::GetOwnedGameplayTags(FGameplayTagContainer& OutOwnedTags) const
+{
+	if (const IGameplayTagAssetInterface* const TagAssetInterface = Cast<IGameplayTagAssetInterface>(GetOwner()))
+	{
+		TagAssetInterface->GetOwnedGameplayTags(OutOwnedTags);
+	}
+	OutOwnedTags.AppendTags(OwnedTags);
+}
+
+const FVetInteractionTagMask& UVetInteractionComponent::GetOwnedTagMask() const
+{
+	//The tags of the owner can change without notice so the mask can't be kept for longer than a frame.
+	const uint32 RegistryVersion = FVetInteractionTagMask::GetRegistryVersion();
+	if (OwnedTagMaskFrame != GFrameCounter
+		|| OwnedTagMaskRegistryVersion != RegistryVersion)
+	{
+		FGameplayTagContainer AllOwnedTags;
+		GetOwnedGameplayTags(AllOwnedTags);
+
+		OwnedTagMask = FVetInteractionTagMask::MakeOwnedMask(AllOwnedTags);
+		OwnedTagMaskFrame = GFrameCounter;
+		OwnedTagMaskRegistryVersion = RegistryVersion;
+	}
+	return OwnedTagMask;
+}
+
+void UVetInteractionComponent::AddOwnedTag(FGameplayTag InTag)
+{
+	OwnedTags.AddTag(InTag);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UVetInteractionComponent, OwnedTags, this);
+	OnRep_OwnedTags();
+}
+
+void UVetInteractionComponent::RemoveOwnedTag(FGameplayTag InTag)
+{
+	OwnedTags.RemoveTag(InTag);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UVetInteractionComponent, OwnedTags, this);
+	OnRep_OwnedTags();
+}
+
+uint32 UVetInteractionComponent::GetOwnedGameplayTagsHash() const
+{
+	FGameplayTagContainer AllOwnedTags;
+	GetOwnedGameplayTags(AllOwnedTags);
+
+	//Summed so the order the tags were added in does not matter, each hash is mixed first so similar tags don't cancel out.
+	uint32 TagsHash = 0;
+	for (const FGameplayTag& Tag : AllOwnedTags)
+	{
+		TagsHash += MurmurFinalize32(GetTypeHash(Tag));
+	}
+	return HashCombine(TagsHash, AllOwnedTags.Num());
+}
+
 void UVetInteractionComponent::SetDefaultTraceChannel(ECollisionChannel InTraceChannel)
 {
 	if (CheckConstructorContext(TEXT("SetDefaultTraceChannel")))
@@ -205,8 +474,33 @@ void UVetInteractionComponent::SetDefaultInteractionRadius(float InInteractionRa
 void UVetInteractionComponent::BeginPlay()
 {
 	Super::BeginPlay();	
+
+	AsyncTraceDelegate.BindUObject(this, &UVetInteractionComponent::OnAsyncTraceCompleted);
+	BaseTickInterval = PrimaryComponentTick.TickInterval;
+	ViewCamera = GetOwner()->FindComponentByClass<UCameraComponent>();
+
+	bUsesTickManager = UVetInteractionSettings::Get().bUseInteractionTickManager
+		&& UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()) != nullptr;
+
+	if (FocusDetector == nullptr && TraceType == EVetInteractionTraceType::Proximity_Overlap && UpdatesFocusLocally())
+	{
+		CreateProximityVolume();
+	}
+
+	if (FocusDetector != nullptr && bClientAuthoritativeFocus)
+	{
+		UE_LOG(LogInteraction, Warning, TEXT("Interactor %s::%s uses a focus detector, client authoritative focus is ignored."), *GetOwner()->GetName(), *GetName());
+	}
 	
 	ConditionallySetTickEnabled(/*bInEnabled =*/ true);
+
+	if (GetOwner()->HasAuthority())
+	{
+		if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+		{
+			InteractionSubsystem->RegisterInteractor(*this);
+		}
+	}
 }
 
 void UVetInteractionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -217,31 +511,95 @@ void UVetInteractionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 		StopInteraction();
 	}
 
-	if (IsValid(InteractionState.GetFocusedComponent()))
+	if (IsValid(FocusedComponent))
 	{
 		SetFocusedComponent(nullptr);
 	}
 
+	if (bFocusUpdatesEnabled)
+	{
+		ConditionallySetTickEnabled(/*bInEnabled =*/ false);
+	}
+
+	if (QueuedStartRequestHandle.IsValid())
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(QueuedStartRequestHandle);
+		QueuedStartRequestHandle.Reset();
+	}
+
+	//Results of a query still in flight are discarded.
+	PendingTraceHandle = FTraceHandle();
+	AsyncTraceDelegate.Unbind();
+
+	DestroyProximityVolume();
+
+	if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+	{
+		InteractionSubsystem->UnregisterInteractor(*this);
+
+		if (bWaitingForHandles)
+		{
+			InteractionSubsystem->SetWaitingForInteractiveHandles(*this, /*bInWaiting =*/ false);
+			bWaitingForHandles = false;
+		}
+	}
+
 	Super::EndPlay(EndPlayReason);
 }
 
-bool UVetInteractionComponent::Server_StartInteraction_Validate(UPrimitiveComponent* InFocusedComponent)
+void UVetInteractionComponent::Server_StartInteraction_Implementation(FVetInteractiveHandle InFocusedHandle, uint8 InPredictionKey, bool bInStopAfterStart)
 {
-	if (TraceType == EVetInteractionTraceType::LineTrace_FromCursor)
+	//Checked before anything else, evaluating the interactive is what makes spammed requests expensive.
+	if (!ConsumeRequestToken())
+	{
+		PrintDebugMessage(1, TEXT("Throttled interaction request"));
+		Client_RejectInteractionStart(InPredictionKey);
+		return;
+	}
+
+	//Null if the client sent no focus or the interactive is gone by now
+	UPrimitiveComponent* const ClientFocusedComponent = ResolveInteractiveHandle(InFocusedHandle);
+
+	bool bStarted = false;
+	if (IsFocusFromLocalPlayer() && !IsValid(ClientFocusedComponent))
 	{
-		return IsValid(InFocusedComponent);
+		PrintDebugMessage(1, TEXT("Unknown client focus"));
+	}
+	else if (bClientAuthoritativeFocus && FocusDetector == nullptr && TraceType == EVetInteractionTraceType::SphereTrace_FromOwner
+		&& (!IsValid(ClientFocusedComponent) || !ValidateClientFocus(*ClientFocusedComponent, InFocusedHandle.GetInstanceIndex())))
+	{
+		PrintDebugMessage(1, TEXT("Rejected client focus"));
+	}
+	else if (IsValid(ClientFocusedComponent))
+	{
+		//The focus stays on the client, the server never tracks it so it has no focus events to end later.
+		bStarted = StartInteraction_Internal(ClientFocusedComponent, InFocusedHandle.GetInstanceIndex(), InPredictionKey);
+	}
+	else
+	{
+		bStarted = StartInteraction_Internal(FocusedComponent, FocusedInstanceIndex, InPredictionKey);
+	}
+
+	//Predicted or not, the client is waiting for an answer
+	if (!bStarted)
+	{
+		Client_RejectInteractionStart(InPredictionKey);
+	}
+	else if (bInStopAfterStart)
+	{
+		StopInteraction();
 	}
-	return true;
 }
 
-void UVetInteractionComponent::Server_StartInteraction_Implementation(UPrimitiveComponent* InFocusedComponent)
+void UVetInteractionComponent::Client_RejectInteractionStart_Implementation(uint8 InPredictionKey)
 {
-	if (IsValid(InFocusedComponent))
+	OnRequestsAnswered();
+	bStopAfterStartRequest = false;
+
+	if (InPredictionKey != 0 && InPredictionKey == PendingPredictionKey)
 	{
-		SetFocusedComponent(InFocusedComponent);
+		RollbackPredictedInteraction();
 	}
-
-	StartInteraction();
 }
 
 void UVetInteractionComponent::Server_StopInteraction_Implementation()
@@ -249,143 +607,514 @@ void UVetInteractionComponent::Server_StopInteraction_Implementation()
 	StopInteraction();
 }
 
-void UVetInteractionComponent::SetFocusedComponent(UPrimitiveComponent* InNewFocusedComponent)
+void UVetInteractionComponent::SendQueuedStartRequest(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	FWorldDelegates::OnWorldPostActorTick.Remove(QueuedStartRequestHandle);
+	QueuedStartRequestHandle.Reset();
+
+	Server_StartInteraction(QueuedStartFocusedHandle, QueuedStartPredictionKey, bStopQueuedStartRequest);
+	bStopQueuedStartRequest = false;
+}
+
+bool UVetInteractionComponent::ShouldSendRequest(double& InOutPendingRequestTime) const
+{
+	const double CurrentTime = GetWorld()->GetRealTimeSeconds();
+	if (InOutPendingRequestTime >= 0.0
+		&& (CurrentTime - InOutPendingRequestTime) < UVetInteractionSettings::Get().InteractionRequestCoalesceTime)
+	{
+		INC_DWORD_STAT(STAT_VetInteraction_CoalescedRequests);
+		return false;
+	}
+
+	InOutPendingRequestTime = CurrentTime;
+	return true;
+}
+
+void UVetInteractionComponent::OnRequestsAnswered()
+{
+	PendingStartRequestTime = -1.0;
+	PendingStopRequestTime = -1.0;
+}
+
+bool UVetInteractionComponent::ConsumeRequestToken()
+{
+	const UVetInteractionSettings& Settings = UVetInteractionSettings::Get();
+	if (Settings.InteractionRequestRate <= 0.0f)
+	{
+		return true;
+	}
+
+	//Real time so pausing or dilating the world doesn't change the limit
+	const double CurrentTime = GetWorld()->GetRealTimeSeconds();
+	const float MaxTokens = static_cast<float>(FMath::Max(Settings.InteractionRequestBurst, 1));
+	RequestTokens = (LastRequestTokenTime < 0.0)
+		? MaxTokens
+		: FMath::Min(MaxTokens, RequestTokens + static_cast<float>(CurrentTime - LastRequestTokenTime) * Settings.InteractionRequestRate);
+	LastRequestTokenTime = CurrentTime;
+
+	if (RequestTokens < 1.0f)
+	{
+		INC_DWORD_STAT(STAT_VetInteraction_ThrottledRequests);
+		return false;
+	}
+
+	RequestTokens -= 1.0f;
+	return true;
+}
+
+void UVetInteractionComponent::SetFocusedComponent(UPrimitiveComponent* InNewFocusedComponent, int32 InNewFocusedInstanceIndex /*= INDEX_NONE*/)
 {
 	//If we are focusing the same actor as before just exit the function
 	//either both null or valid.
-	if (InteractionState.GetFocusedComponent() == InNewFocusedComponent)
+	if (FocusedComponent == InNewFocusedComponent && FocusedInstanceIndex == InNewFocusedInstanceIndex)
 	{
 		return;
 	}
 
-	SwitchFocusedComponent(InNewFocusedComponent, InteractionState.GetFocusedComponent());
+	//Moving between instances of the same component ends the focus on the previous instance too.
+	SwitchFocusedComponent(InNewFocusedComponent, InNewFocusedInstanceIndex, FocusedComponent, FocusedInstanceIndex);
 
 	//We might be removing focus from all actors.
-	InteractionState.SetFocusedComponent(InNewFocusedComponent);
+	FocusedComponent = InNewFocusedComponent;
+	FocusedInstanceIndex = InNewFocusedInstanceIndex;
+
+	if (GetOwner()->HasAuthority())
+	{
+		FocusedHandle = MakeInteractiveHandle(InNewFocusedComponent).WithInstance(InNewFocusedInstanceIndex);
+		MARK_PROPERTY_DIRTY_FROM_NAME(UVetInteractionComponent, FocusedHandle, this);
+
+		if (bReplicateFocusToEveryone)
+		{
+			SharedFocusedHandle = FocusedHandle;
+			MARK_PROPERTY_DIRTY_FROM_NAME(UVetInteractionComponent, SharedFocusedHandle, this);
+		}
+	}
+}
+
+FVetInteractiveHandle UVetInteractionComponent::MakeInteractiveHandle(UPrimitiveComponent* InPrimitive) const
+{
+	const UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	return InteractionSubsystem ? InteractionSubsystem->MakePrimitiveHandle(InPrimitive) : FVetInteractiveHandle();
+}
+
+UPrimitiveComponent* UVetInteractionComponent::ResolveInteractiveHandle(const FVetInteractiveHandle& InHandle) const
+{
+	const UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	return InteractionSubsystem ? InteractionSubsystem->ResolvePrimitiveHandle(InHandle) : nullptr;
 }
 
-void UVetInteractionComponent::SwitchFocusedComponent(UPrimitiveComponent* InNewFocusedComponent, UPrimitiveComponent* InPreviousFocusedComponent)
+void UVetInteractionComponent::SwitchFocusedComponent(UPrimitiveComponent* InNewFocusedComponent, int32 InNewFocusedInstanceIndex, UPrimitiveComponent* InPreviousFocusedComponent, int32 InPreviousFocusedInstanceIndex)
 {
 	//Remove focus from previous actor
 	if (InPreviousFocusedComponent != nullptr)
 	{
 		AActor* PreviousFocusedActor = InPreviousFocusedComponent->GetOwner();
-		IVetInteractiveInterface::EndFocusedOn_Internal(*this, PreviousFocusedActor, InPreviousFocusedComponent);
+		IVetInteractiveInterface::EndFocusedOn_Internal(*this, PreviousFocusedActor, InPreviousFocusedComponent, InPreviousFocusedInstanceIndex);
 	}
 
 	//Focus on the new actor
 	if (InNewFocusedComponent != nullptr)
 	{
 		AActor* NewFocusedActor = InNewFocusedComponent->GetOwner();
-		IVetInteractiveInterface::BeginFocusedOn_Internal(*this, NewFocusedActor, InNewFocusedComponent);
+		IVetInteractiveInterface::BeginFocusedOn_Internal(*this, NewFocusedActor, InNewFocusedComponent, InNewFocusedInstanceIndex);
 	}
 }
 
-UPrimitiveComponent* UVetInteractionComponent::GetClosestPrimitiveFromArray(const TArray<UPrimitiveComponent*>& InPrimitivesArray)
+template<typename TDetector>
+const UVetInteractionComponent::FFocusCandidate* UVetInteractionComponent::GetBestScoredCandidate(const TDetector& InDetector, const FVetFocusQuery& InQuery, const TArray<FFocusCandidate>& InCandidates) const
 {
-	const auto& GetReferenceLocation([&]()
+	const FFocusCandidate* BestCandidate = nullptr;
+	float BestScore = 0.0f;
+	for (const FFocusCandidate& Candidate : InCandidates)
+	{
+		if (IsValid(Candidate.Primitive))
 		{
-			if (auto* const CameraComponent = GetOwner()->FindComponentByClass<UCameraComponent>())
+			const float Score = InDetector.ScoreCandidate(InQuery, Candidate.Location);
+			if (BestCandidate == nullptr || Score < BestScore)
 			{
-				return CameraComponent->GetComponentLocation();
+				BestScore = Score;
+				BestCandidate = &Candidate;
 			}
+		}
+	}
+	return BestCandidate;
+}
+
+const UVetInteractionComponent::FFocusCandidate* UVetInteractionComponent::GetClosestCandidate(const TArray<FFocusCandidate>& InCandidates) const
+{
+	if (FocusDetector != nullptr)
+	{
+		const FVetFocusQuery Query(*this, /*bInFromTouch =*/ false);
+		return VetInteractionComponent::VisitFocusDetector(*FocusDetector, [&](const auto& InDetector)
+			{
+				return GetBestScoredCandidate(InDetector, Query, InCandidates);
+			});
+	}
+
+	if (InCandidates.Num() == 0)
+	{
+		return nullptr;
+	}
 
-			return GetOwner()->GetActorLocation();
-		});
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_ScoreFocusCandidates);
+
+	FVector ViewLocation;
+	FVector ViewDirection;
+	GetViewPoint(ViewLocation, ViewDirection);
+
+	//Gathered as offsets from the view so they keep their precision as floats, the padding scores are ignored.
+	const int32 PaddedNum = Align(InCandidates.Num(), 4);
+	TArray<float, TInlineAllocator<32>> OffsetsX;
+	TArray<float, TInlineAllocator<32>> OffsetsY;
+	TArray<float, TInlineAllocator<32>> OffsetsZ;
+	TArray<float, TInlineAllocator<32>> Priorities;
+	TArray<float, TInlineAllocator<32>> Scores;
+	OffsetsX.SetNumZeroed(PaddedNum);
+	OffsetsY.SetNumZeroed(PaddedNum);
+	OffsetsZ.SetNumZeroed(PaddedNum);
+	Priorities.SetNumZeroed(PaddedNum);
+	Scores.SetNumUninitialized(PaddedNum);
+
+	for (int32 Index = 0; Index < InCandidates.Num(); ++Index)
+	{
+		const FVector Offset = InCandidates[Index].Location - ViewLocation;
+		OffsetsX[Index] = static_cast<float>(Offset.X);
+		OffsetsY[Index] = static_cast<float>(Offset.Y);
+		OffsetsZ[Index] = static_cast<float>(Offset.Z);
+		Priorities[Index] = InCandidates[Index].Priority;
+	}
 
-	const FVector& ReferenceLocation = GetReferenceLocation();
+	VetInteractionComponent::ScoreFocusCandidates(FVector3f(ViewDirection), FocusAngleWeight, OffsetsX.GetData(), OffsetsY.GetData(), OffsetsZ.GetData(), Priorities.GetData(), Scores.GetData(), PaddedNum);
 
-	auto ClosestActor = TPairInitializer<float, UPrimitiveComponent*>(-1.0f, nullptr);
-	for (UPrimitiveComponent* Primitive : InPrimitivesArray)
+	const FFocusCandidate* BestCandidate = nullptr;
+	float BestScore = 0.0f;
+	for (int32 Index = 0; Index < InCandidates.Num(); ++Index)
 	{
-		if (IsValid(Primitive))
+		if (IsValid(InCandidates[Index].Primitive)
+			&& (BestCandidate == nullptr || Scores[Index] < BestScore))
 		{
-			const float Distance = FVector(Primitive->GetComponentLocation() - ReferenceLocation).SizeSquared();
-			if (ClosestActor.Value == nullptr
-				|| Distance < ClosestActor.Key)
-			{
-				ClosestActor.Key = Distance;
-				ClosestActor.Value = Primitive;
-			}
+			BestScore = Scores[Index];
+			BestCandidate = &InCandidates[Index];
 		}
 	}
-	return ClosestActor.Value;
+	return BestCandidate;
+}
+
+bool UVetInteractionComponent::IsFocusedInstanceAvailable() const
+{
+	if (FocusedInstanceIndex == INDEX_NONE)
+	{
+		return true;
+	}
+
+	const UVetInteractiveComponent* const InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(GetFocusedActor());
+	return InteractiveComponent != nullptr && InteractiveComponent->GetInstanceInteractability(FocusedInstanceIndex) == EVetInteractability::Available;
 }
 
 void UVetInteractionComponent::OnInteractionCompleted(UVetInteractiveComponent& InInteractive)
 {
-	if (InteractionState.GetFocusedActor() == nullptr)
+	if (InteractionState.GetInteractingActor() == nullptr)
 	{
 		//TODO: log this, this should never happen
 		return;
 	}
 
-	UVetInteractiveComponent* InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(InteractionState.GetFocusedActor());
+	UVetInteractiveComponent* InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(InteractionState.GetInteractingActor());
 	if (&InInteractive != InteractiveComponent)
 	{
 		//TODO: log this.
 		return;
 	}
 
-	InteractionState.SetIsInteracting(false);
+	//Instant interactions never set the interacting state, other machines get them through the instant interaction event of the interactive.
 	InteractionState.SetResult(EVetInteractionResult::Success);
+	if (InteractionState.IsInteracting())
+	{
+		InteractionState.SetIsInteracting(false);
+		MarkInteractionStateDirty();
+	}
 
 	OnInteractionEnded_Internal();
 }
 
+void UVetInteractionComponent::OnInstantInteractionReplicated(UVetInteractiveComponent& InInteractive)
+{
+	OnRequestsAnswered();
+	bStopAfterStartRequest = false;
+	OnInteractionStarted.Broadcast(&InInteractive);
+	OnInteractionEnded.Broadcast(&InInteractive, EVetInteractionResult::Success);
+}
+
 void UVetInteractionComponent::OnInteractionEnded_Internal()
 {
-	UVetInteractiveComponent* CurrentInteractive = IVetInteractiveInterface::GetInteractiveComponent_Internal(InteractionState.GetFocusedActor());
+	UVetInteractiveComponent* CurrentInteractive = IVetInteractiveInterface::GetInteractiveComponent_Internal(InteractionState.GetInteractingActor());
 	OnInteractionEnded.Broadcast(CurrentInteractive, InteractionState.GetResult());
 
 	//Re-enable ticking on the server
-	if (!PrimaryComponentTick.IsTickFunctionEnabled())
+	if (!bFocusUpdatesEnabled)
 	{
 		ConditionallySetTickEnabled(/*bInEnabled =*/ true);
 	}
 }
 
-void UVetInteractionComponent::TraceForInteractives(bool bInFromTouch /*= false*/)
+bool UVetInteractionComponent::ShouldTraceForInteractives()
 {
-	TArray<FHitResult> HitResults;
-	TArray<AActor*> ActorsToIgnore{ GetOwner() };
+	if (FocusDetector != nullptr)
+	{
+		return true;
+	}
+
+	if (TraceType == EVetInteractionTraceType::Proximity_Overlap)
+	{
+		return ShouldRescoreProximityCandidates();
+	}
 
 	if (TraceType == EVetInteractionTraceType::LineTrace_FromCursor)
 	{
-		FHitResult& HitResult = HitResults.Emplace_GetRef();
-		GetTraceHitForLocalPlayerCursor(HitResult);
-#if WITH_EDITOR
-		if (IsValid(HitResult.GetActor()))
+		return ShouldTraceFromCursor();
+	}
+
+	if (!bAdaptiveUpdateRate || TraceType != EVetInteractionTraceType::SphereTrace_FromOwner)
+	{
+		return true;
+	}
+
+	const AActor* const Owner = GetOwner();
+
+	//Update more often while moving quickly
+	const bool bIsMovingFast = Owner->GetVelocity().SizeSquared() >= FMath::Square(FastMovementSpeed);
+	const float DesiredTickInterval = bIsMovingFast ? FMath::Min(FastMovementUpdateInterval, BaseTickInterval) : BaseTickInterval;
+	if (!FMath::IsNearlyEqual(PrimaryComponentTick.TickInterval, DesiredTickInterval))
+	{
+		SetComponentTickInterval(DesiredTickInterval);
+	}
+
+	FVector StartLocation;
+	FVector EndLocation;
+	GetSphereTraceLocations(StartLocation, EndLocation);
+
+	const FBox TraceBounds(StartLocation.ComponentMin(EndLocation) - FVector(InteractionRadius), StartLocation.ComponentMax(EndLocation) + FVector(InteractionRadius));
+	const UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	const uint32 RegionVersion = InteractionSubsystem ? InteractionSubsystem->GetRegionVersion(TraceBounds) : 0;
+
+	const FVector Location = Owner->GetActorLocation();
+	const FRotator Rotation = Owner->GetActorRotation();
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	const bool bHasMoved = FVector::DistSquared(Location, LastTraceLocation) > FMath::Square(AdaptiveLocationThreshold)
+		|| !Rotation.Equals(LastTraceRotation, AdaptiveRotationThreshold);
+
+	if (LastTraceTime >= 0.0
+		&& !bHasMoved
+		&& RegionVersion == LastTraceRegionVersion
+		&& (CurrentTime - LastTraceTime) < AdaptiveMaxSkipTime)
+	{
+		return false;
+	}
+
+	LastTraceLocation = Location;
+	LastTraceRotation = Rotation;
+	LastTraceRegionVersion = RegionVersion;
+	LastTraceTime = CurrentTime;
+	return true;
+}
+
+bool UVetInteractionComponent::ShouldRescoreProximityCandidates()
+{
+	if (!IsValid(ProximityVolume))
+	{
+		return false;
+	}
+
+	//Catches interactives that changed their interactability while inside the volume
+	const UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	const uint32 RegionVersion = InteractionSubsystem ? InteractionSubsystem->GetRegionVersion(ProximityVolume->Bounds.GetBox()) : 0;
+
+	const FVector Location = GetOwner()->GetActorLocation();
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	if (LastTraceTime >= 0.0
+		&& !bProximityCandidatesChanged
+		&& RegionVersion == LastTraceRegionVersion
+		&& FVector::DistSquared(Location, LastTraceLocation) <= FMath::Square(ProximityLocationThreshold)
+		&& (CurrentTime - LastTraceTime) < AdaptiveMaxSkipTime)
+	{
+		return false;
+	}
+
+	bProximityCandidatesChanged = false;
+	LastTraceLocation = Location;
+	LastTraceRegionVersion = RegionVersion;
+	LastTraceTime = CurrentTime;
+	return true;
+}
+
+bool UVetInteractionComponent::ShouldTraceFromCursor()
+{
+	if (!bAdaptiveUpdateRate)
+	{
+		return true;
+	}
+
+	const APlayerController* const PC = GetWorld()->GetFirstPlayerController();
+	float CursorX = 0.0f;
+	float CursorY = 0.0f;
+	if (!IsValid(PC) || !IsValid(PC->PlayerCameraManager) || !PC->GetMousePosition(CursorX, CursorY))
+	{
+		return true;
+	}
+
+	const FVector2f CursorPosition(CursorX, CursorY);
+	const FVector CameraLocation = PC->PlayerCameraManager->GetCameraLocation();
+	const FRotator CameraRotation = PC->PlayerCameraManager->GetCameraRotation();
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	//The same pixel from the same view hits the same thing unless an interactive changed in front of the hit.
+	//Without a hit the ray has no end so it is traced again, other changes are caught by the max skip time.
+	const UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	const uint32 RegionVersion = InteractionSubsystem && LastCursorTraceRegion.IsValid ? InteractionSubsystem->GetRegionVersion(LastCursorTraceRegion) : 0;
+
+	if (LastTraceTime >= 0.0
+		&& LastCursorTraceRegion.IsValid
+		&& RegionVersion == LastTraceRegionVersion
+		&& CursorPosition == LastCursorPosition
+		&& CameraLocation.Equals(LastTraceLocation)
+		&& CameraRotation.Equals(LastTraceRotation)
+		&& (CurrentTime - LastTraceTime) < AdaptiveMaxSkipTime)
+	{
+		return false;
+	}
+
+	LastCursorPosition = CursorPosition;
+	LastTraceLocation = CameraLocation;
+	LastTraceRotation = CameraRotation;
+	LastTraceTime = CurrentTime;
+	return true;
+}
+
+void UVetInteractionComponent::RecordCursorTraceRegion(const FHitResult& InHitResult)
+{
+	LastCursorTraceRegion = InHitResult.bBlockingHit
+		? FBox(InHitResult.TraceStart.ComponentMin(InHitResult.Location), InHitResult.TraceStart.ComponentMax(InHitResult.Location))
+		: FBox(ForceInit);
+
+	const UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	LastTraceRegionVersion = InteractionSubsystem && LastCursorTraceRegion.IsValid ? InteractionSubsystem->GetRegionVersion(LastCursorTraceRegion) : 0;
+}
+
+void UVetInteractionComponent::TraceForInteractives(bool bInFromTouch /*= false*/)
+{
+	//Touch interactions need the result right away so they always run a blocking trace.
+	//Neither the spatial index nor the proximity candidates are physics queries so there is nothing to run asynchronously.
+	if (bUseAsyncTraces && !bInFromTouch && FocusDetector == nullptr
+		&& (TraceType == EVetInteractionTraceType::LineTrace_FromCursor
+			|| (TraceType == EVetInteractionTraceType::SphereTrace_FromOwner && !bUseSpatialIndex)))
+	{
+		SubmitAsyncTrace();
+		return;
+	}
+
+	TArray<FHitResult> HitResults;
+	TArray<AActor*> ActorsToIgnore{ GetOwner() };
+
+	if (FocusDetector != nullptr)
+	{
+		const FVetFocusQuery Query(*this, bInFromTouch);
+		VetInteractionComponent::VisitFocusDetector(*FocusDetector, [&](const auto& InDetector)
+			{
+				InDetector.GatherCandidates(Query, HitResults);
+			});
+	}
+	else if (TraceType == EVetInteractionTraceType::LineTrace_FromCursor)
+	{
+		FHitResult& HitResult = HitResults.Emplace_GetRef();
+		GetTraceHitForLocalPlayerCursor(HitResult, bInFromTouch);
+		RecordCursorTraceRegion(HitResult);
+#if WITH_EDITOR
+		if (IsValid(HitResult.GetActor()))
 		{
 			PrintDebugMessage(0, FString::Printf(TEXT("Hit Actor: %s"), *HitResult.GetActor()->GetName()));
 		}
 #endif //WITH_EDITOR
 	}
+	else if (TraceType == EVetInteractionTraceType::Proximity_Overlap)
+	{
+		GetProximityHits(HitResults);
+	}
 	else
 	{
 		//Multi sphere trace from owning actor
-		const FVector StartLocation = GetOwner()->GetActorLocation();
-		const FVector EndLocation = StartLocation + (GetOwner()->GetActorForwardVector() * InteractionDistance);
-		UKismetSystemLibrary::SphereTraceMulti(this, StartLocation, EndLocation, InteractionRadius, UEngineTypes::ConvertToTraceType(TraceChannel), false, ActorsToIgnore, EDrawDebugTrace::None, HitResults, true);
+		FVector StartLocation;
+		FVector EndLocation;
+		GetSphereTraceLocations(StartLocation, EndLocation);
+		if (bUseSpatialIndex)
+		{
+			GetSpatialIndexHits(StartLocation, EndLocation, HitResults);
+		}
+		else
+		{
+			SCOPE_CYCLE_COUNTER(STAT_VetInteraction_PhysicsFocusTrace);
+			UKismetSystemLibrary::SphereTraceMulti(this, StartLocation, EndLocation, InteractionRadius, UEngineTypes::ConvertToTraceType(TraceChannel), false, ActorsToIgnore, EDrawDebugTrace::None, HitResults, true);
+		}
 	}
 
-	if (HitResults.Num() > 0)
+	SetFocusFromHitResults(HitResults);
+}
+
+void UVetInteractionComponent::GetSphereTraceLocations(FVector& OutStartLocation, FVector& OutEndLocation) const
+{
+	OutStartLocation = GetOwner()->GetActorLocation();
+	OutEndLocation = OutStartLocation + (GetOwner()->GetActorForwardVector() * InteractionDistance);
+}
+
+void UVetInteractionComponent::SetFocusFromHitResults(const TArray<FHitResult>& InHitResults)
+{
+	if (InHitResults.Num() > 0)
 	{
-		TArray<UPrimitiveComponent*> FoundInteractives;
-		for (const FHitResult& HitResult : HitResults)
+		TArray<FFocusCandidate> Candidates;
+		for (const FHitResult& HitResult : InHitResults)
 		{
 			AActor* const HitActor = HitResult.GetActor();
-			const bool bDoesImplementInterface = UKismetSystemLibrary::DoesImplementInterface(HitActor, UVetInteractiveInterface::StaticClass());
-			if (IsValid(HitActor)
-				&& bDoesImplementInterface
-				&& IVetInteractiveInterface::CanBeFocusedOn_Internal(HitActor, this))	//Ignore interactives that cannot be focused on
+			UPrimitiveComponent* const HitComponent = HitResult.GetComponent();
+			if (!IsValid(HitComponent)
+				|| !IVetInteractiveInterface::ImplementsInterface_Internal(HitActor)
+				|| !IVetInteractiveInterface::CanBeFocusedOn_Internal(HitActor, this))	//Ignore interactives that cannot be focused on
 			{
-				FoundInteractives.Emplace(HitResult.GetComponent());
+				continue;
 			}
+
+			const UVetInteractiveComponent* const InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(HitActor);
+
+			FFocusCandidate Candidate;
+			Candidate.Primitive = HitComponent;
+			Candidate.Location = HitComponent->GetComponentLocation();
+			Candidate.Priority = InteractiveComponent ? InteractiveComponent->GetFocusPriority() : 0.0f;
+
+			//Each instance of a per instance interactive is a candidate on its own
+			const UInstancedStaticMeshComponent* const InstancedMesh = Cast<UInstancedStaticMeshComponent>(HitComponent);
+			if (InstancedMesh != nullptr && InteractiveComponent != nullptr && InteractiveComponent->UsesPerInstanceInteraction() && HitResult.Item != INDEX_NONE)
+			{
+				FTransform InstanceTransform;
+				if (InteractiveComponent->GetInstanceInteractability(HitResult.Item) == EVetInteractability::Unavailable
+					|| !InstancedMesh->GetInstanceTransform(HitResult.Item, InstanceTransform, /*bWorldSpace =*/ true))
+				{
+					continue;
+				}
+
+				Candidate.InstanceIndex = HitResult.Item;
+				Candidate.Location = InstanceTransform.GetLocation();
+			}
+
+			Candidates.Add(Candidate);
 		}
 
-		UPrimitiveComponent* const ClosestInteractive = GetClosestPrimitiveFromArray(FoundInteractives);
-		SetFocusedComponent(ClosestInteractive);
+		const FFocusCandidate* const ClosestCandidate = GetClosestCandidate(Candidates);
+		SetFocusedComponent(ClosestCandidate ? ClosestCandidate->Primitive : nullptr, ClosestCandidate ? ClosestCandidate->InstanceIndex : INDEX_NONE);
 	}
 	else
 	{
@@ -393,6 +1122,147 @@ void UVetInteractionComponent::TraceForInteractives(bool bInFromTouch /*= false*
 	}
 }
 
+void UVetInteractionComponent::SubmitAsyncTrace()
+{
+	//Only one query in flight at a time, the previous one is consumed on the next frame.
+	if (PendingTraceHandle.IsValid())
+	{
+		return;
+	}
+
+	UWorld* const World = GetWorld();
+
+	if (TraceType == EVetInteractionTraceType::LineTrace_FromCursor)
+	{
+		APlayerController* const PC = World->GetFirstPlayerController();
+		if (!IsValid(PC) || !PC->IsLocalController())
+		{
+			return;
+		}
+
+		FVector CursorLocation;
+		FVector CursorDirection;
+		if (!PC->DeprojectMousePositionToWorld(CursorLocation, CursorDirection))
+		{
+			return;
+		}
+
+		//Same query as a blocking cursor trace, precise picking is done once the result is received.
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetInteractionAsyncCursorTrace), /*bTraceComplex =*/ false);
+		const FVector EndLocation = CursorLocation + (CursorDirection * PC->HitResultTraceDistance);
+		PendingTraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, CursorLocation, EndLocation, TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate);
+	}
+	else
+	{
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetInteractionAsyncFocusTrace), /*bTraceComplex =*/ false, GetOwner());
+		FVector StartLocation;
+		FVector EndLocation;
+		GetSphereTraceLocations(StartLocation, EndLocation);
+		PendingTraceHandle = World->AsyncSweepByChannel(EAsyncTraceType::Multi, StartLocation, EndLocation, FQuat::Identity, TraceChannel, FCollisionShape::MakeSphere(InteractionRadius), QueryParams, FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate);
+	}
+}
+
+void UVetInteractionComponent::OnAsyncTraceCompleted(const FTraceHandle& InTraceHandle, FTraceDatum& InTraceDatum)
+{
+	if (InTraceHandle != PendingTraceHandle)
+	{
+		return;
+	}
+
+	PendingTraceHandle = FTraceHandle();
+
+	//An interaction might have started or been predicted while the query was in flight, focus must not change during it.
+	if (IsInteractingOrPredicting() || !bFocusUpdatesEnabled)
+	{
+		return;
+	}
+
+	if (TraceType == EVetInteractionTraceType::LineTrace_FromCursor)
+	{
+		if (InTraceDatum.OutHits.Num() > 0)
+		{
+			RefineCursorHit(InTraceDatum.OutHits[0], InTraceDatum.Start, InTraceDatum.End);
+		}
+		RecordCursorTraceRegion(InTraceDatum.OutHits.Num() > 0 ? InTraceDatum.OutHits[0] : FHitResult());
+	}
+
+	SetFocusFromHitResults(InTraceDatum.OutHits);
+}
+
+void UVetInteractionComponent::GetSpatialIndexHits(const FVector& InStartLocation, const FVector& InEndLocation, TArray<FHitResult>& OutHitResults) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_SpatialIndexFocusTrace);
+
+	UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	if (InteractionSubsystem == nullptr)
+	{
+		return;
+	}
+
+	TArray<UPrimitiveComponent*> CandidatePrimitives;
+	InteractionSubsystem->QueryInteractivePrimitives(InStartLocation, InEndLocation, InteractionRadius, TraceChannel, GetOwner(), CandidatePrimitives);
+
+	const FCollisionShape SweepShape = FCollisionShape::MakeSphere(InteractionRadius);
+	for (UPrimitiveComponent* const Primitive : CandidatePrimitives)
+	{
+		//The bounds of an instanced mesh cover every instance, per instance interactives gather their instances instead.
+		if (UInstancedStaticMeshComponent* const InstancedMesh = Cast<UInstancedStaticMeshComponent>(Primitive))
+		{
+			const UVetInteractiveComponent* const InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(Primitive->GetOwner());
+			if (InteractiveComponent != nullptr && InteractiveComponent->UsesPerInstanceInteraction())
+			{
+				GetInstanceHits(*InstancedMesh, InStartLocation, InEndLocation, OutHitResults);
+				continue;
+			}
+		}
+
+		if (bSpatialIndexNarrowPhase)
+		{
+			//Only the few candidates that survived the index lookup are swept against.
+			FHitResult HitResult;
+			if (Primitive->SweepComponent(HitResult, InStartLocation, InEndLocation, FQuat::Identity, SweepShape, /*bTraceComplex =*/ false))
+			{
+				OutHitResults.Add(HitResult);
+			}
+		}
+		else
+		{
+			OutHitResults.Emplace(Primitive->GetOwner(), Primitive, Primitive->Bounds.Origin, FVector::ZeroVector);
+		}
+	}
+}
+
+void UVetInteractionComponent::GetInstanceHits(UInstancedStaticMeshComponent& InInstancedMesh, const FVector& InStartLocation, const FVector& InEndLocation, TArray<FHitResult>& OutHitResults) const
+{
+	const UStaticMesh* const StaticMesh = InInstancedMesh.GetStaticMesh();
+	if (StaticMesh == nullptr)
+	{
+		return;
+	}
+
+	//The instance tree is queried with the sphere around the sweep, then each instance is tested against the swept sphere.
+	const FVector QueryCenter = (InStartLocation + InEndLocation) * 0.5;
+	const float QueryRadius = FVector::Dist(InStartLocation, InEndLocation) * 0.5f + InteractionRadius;
+	const float MeshRadius = StaticMesh->GetBounds().SphereRadius;
+
+	for (const int32 InstanceIndex : InInstancedMesh.GetInstancesOverlappingSphere(QueryCenter, QueryRadius, /*bSphereInWorldSpace =*/ true))
+	{
+		FTransform InstanceTransform;
+		if (!InInstancedMesh.GetInstanceTransform(InstanceIndex, InstanceTransform, /*bWorldSpace =*/ true))
+		{
+			continue;
+		}
+
+		const FVector InstanceLocation = InstanceTransform.GetLocation();
+		const float MaxDistance = InteractionRadius + (MeshRadius * InstanceTransform.GetMaximumAxisScale());
+		if (FMath::PointDistToSegmentSquared(InstanceLocation, InStartLocation, InEndLocation) <= FMath::Square(MaxDistance))
+		{
+			FHitResult& HitResult = OutHitResults.Emplace_GetRef(InInstancedMesh.GetOwner(), &InInstancedMesh, InstanceLocation, FVector::ZeroVector);
+			HitResult.Item = InstanceIndex;
+		}
+	}
+}
+
 void UVetInteractionComponent::GetTraceHitForLocalPlayerCursor(FHitResult& OutResult, bool bInFromTouch /*= false*/) const
 {
 	APlayerController* PC = GetWorld()->GetFirstPlayerController();
@@ -401,37 +1271,222 @@ void UVetInteractionComponent::GetTraceHitForLocalPlayerCursor(FHitResult& OutRe
 		return;
 	}
 
+	float ScreenX = 0.0f;
+	float ScreenY = 0.0f;
 	if (bInFromTouch)
 	{
-		PC->GetHitResultUnderFinger(ETouchIndex::Touch1, TraceChannel, /*bTraceComplex =*/ true, OutResult);
+		bool bIsPressed = false;
+		PC->GetInputTouchState(ETouchIndex::Touch1, ScreenX, ScreenY, bIsPressed);
+		if (!bIsPressed)
+		{
+			return;
+		}
+	}
+	else if (!PC->GetMousePosition(ScreenX, ScreenY))
+	{
+		return;
+	}
+
+	FVector StartLocation;
+	FVector Direction;
+	if (!PC->DeprojectScreenPositionToWorld(ScreenX, ScreenY, StartLocation, Direction))
+	{
+		return;
+	}
+
+	//Simple collision first, per triangle traces only run against the interactives that ask for them.
+	const FVector EndLocation = StartLocation + (Direction * PC->HitResultTraceDistance);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetInteractionCursorTrace), /*bTraceComplex =*/ false);
+	if (GetWorld()->LineTraceSingleByChannel(OutResult, StartLocation, EndLocation, TraceChannel, QueryParams))
+	{
+		RefineCursorHit(OutResult, StartLocation, EndLocation);
+	}
+}
+
+void UVetInteractionComponent::RefineCursorHit(FHitResult& InOutHitResult, const FVector& InStartLocation, const FVector& InEndLocation) const
+{
+	UPrimitiveComponent* const HitComponent = InOutHitResult.GetComponent();
+	const UVetInteractiveComponent* const InteractiveComponent = HitComponent ? IVetInteractiveInterface::GetInteractiveComponent_Internal(InOutHitResult.GetActor()) : nullptr;
+	if (InteractiveComponent == nullptr || !InteractiveComponent->UsesPrecisePicking())
+	{
+		return;
+	}
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetInteractionPrecisePick), /*bTraceComplex =*/ true);
+	FHitResult ComplexHitResult;
+	if (HitComponent->LineTraceComponent(ComplexHitResult, InStartLocation, InEndLocation, QueryParams))
+	{
+		InOutHitResult = ComplexHitResult;
 	}
 	else
 	{
-		PC->GetHitResultUnderCursor(TraceChannel, /*bTraceComplex =*/ true, OutResult);
+		InOutHitResult = FHitResult();
 	}
 }
 
+void UVetInteractionComponent::GetProximityHits(TArray<FHitResult>& OutHitResults) const
+{
+	const FVector Location = GetOwner()->GetActorLocation();
+	for (const TPair<TWeakObjectPtr<UPrimitiveComponent>, int32>& Candidate : ProximityCandidates)
+	{
+		UPrimitiveComponent* const Primitive = Candidate.Key.Get();
+		if (Primitive == nullptr)
+		{
+			continue;
+		}
+
+		if (UInstancedStaticMeshComponent* const InstancedMesh = Cast<UInstancedStaticMeshComponent>(Primitive))
+		{
+			const UVetInteractiveComponent* const InteractiveComponent = IVetInteractiveInterface::GetInteractiveComponent_Internal(Primitive->GetOwner());
+			if (InteractiveComponent != nullptr && InteractiveComponent->UsesPerInstanceInteraction())
+			{
+				GetInstanceHits(*InstancedMesh, Location, Location, OutHitResults);
+				continue;
+			}
+		}
+
+		OutHitResults.Emplace(Primitive->GetOwner(), Primitive, Primitive->Bounds.Origin, FVector::ZeroVector);
+	}
+}
+
+void UVetInteractionComponent::CreateProximityVolume()
+{
+	AActor* const Owner = GetOwner();
+
+	ProximityVolume = NewObject<USphereComponent>(Owner, MakeUniqueObjectName(Owner, USphereComponent::StaticClass(), TEXT("InteractionProximityVolume")));
+	ProximityVolume->SetSphereRadius(InteractionRadius, /*bUpdateOverlaps =*/ false);
+	ProximityVolume->SetCanEverAffectNavigation(false);
+
+	//Overlaps every object type without blocking anything, interaction traces of other interactors ignore it
+	ProximityVolume->SetCollisionObjectType(ProximityObjectType);
+	ProximityVolume->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	ProximityVolume->SetCollisionResponseToAllChannels(ECR_Overlap);
+	if (UEngineTypes::ConvertToObjectType(TraceChannel) == ObjectTypeQuery_MAX)
+	{
+		ProximityVolume->SetCollisionResponseToChannel(TraceChannel, ECR_Ignore);
+	}
+	ProximityVolume->SetGenerateOverlapEvents(true);
+
+	ProximityVolume->OnComponentBeginOverlap.AddDynamic(this, &UVetInteractionComponent::OnProximityBeginOverlap);
+	ProximityVolume->OnComponentEndOverlap.AddDynamic(this, &UVetInteractionComponent::OnProximityEndOverlap);
+	ProximityVolume->SetupAttachment(Owner->GetRootComponent());
+	ProximityVolume->RegisterComponent();
+
+	//Picks up the interactives the owner spawned on top of
+	ProximityVolume->UpdateOverlaps();
+}
+
+void UVetInteractionComponent::DestroyProximityVolume()
+{
+	if (IsValid(ProximityVolume))
+	{
+		ProximityVolume->OnComponentBeginOverlap.RemoveDynamic(this, &UVetInteractionComponent::OnProximityBeginOverlap);
+		ProximityVolume->OnComponentEndOverlap.RemoveDynamic(this, &UVetInteractionComponent::OnProximityEndOverlap);
+		ProximityVolume->DestroyComponent();
+	}
+
+	ProximityVolume = nullptr;
+	ProximityCandidates.Empty();
+}
+
+void UVetInteractionComponent::OnProximityBeginOverlap(UPrimitiveComponent* InOverlappedComponent, AActor* InOtherActor, UPrimitiveComponent* InOtherComponent, int32 InOtherBodyIndex, bool bInFromSweep, const FHitResult& InSweepResult)
+{
+	if (InOtherActor == GetOwner() || !IsValid(InOtherComponent)
+		|| !IVetInteractiveInterface::ImplementsInterface_Internal(InOtherActor))
+	{
+		return;
+	}
+
+	//Instanced meshes overlap once per instance
+	int32& OverlapCount = ProximityCandidates.FindOrAdd(InOtherComponent);
+	if (OverlapCount++ == 0)
+	{
+		bProximityCandidatesChanged = true;
+		ConditionallySetTickEnabled(bFocusUpdatesEnabled);
+	}
+}
+
+void UVetInteractionComponent::OnProximityEndOverlap(UPrimitiveComponent* InOverlappedComponent, AActor* InOtherActor, UPrimitiveComponent* InOtherComponent, int32 InOtherBodyIndex)
+{
+	int32* const OverlapCount = ProximityCandidates.Find(InOtherComponent);
+	if (OverlapCount == nullptr || --(*OverlapCount) > 0)
+	{
+		return;
+	}
+
+	ProximityCandidates.Remove(InOtherComponent);
+	bProximityCandidatesChanged = true;
+
+	//Nothing left to score, clear the focus now so updates can stop
+	if (ProximityCandidates.Num() == 0 && !IsInteractingOrPredicting() && FocusedComponent != nullptr)
+	{
+		SetFocusedComponent(nullptr);
+	}
+
+	ConditionallySetTickEnabled(bFocusUpdatesEnabled);
+}
+
 void UVetInteractionComponent::ConditionallySetTickEnabled(bool bInEnabled)
 {
-	if ((TraceType == EVetInteractionTraceType::LineTrace_FromCursor && IsLocal())
-		|| TraceType != EVetInteractionTraceType::LineTrace_FromCursor && GetOwner()->HasAuthority())
+	if (UpdatesFocusLocally())
 	{
-		PrimaryComponentTick.SetTickFunctionEnable(bInEnabled);
+		bFocusUpdatesEnabled = bInEnabled;
+
+		//Proximity focus costs nothing while there is nothing around
+		const bool bShouldTick = bInEnabled
+			&& (FocusDetector != nullptr || TraceType != EVetInteractionTraceType::Proximity_Overlap || ProximityCandidates.Num() > 0 || FocusedComponent != nullptr);
+
+		if (bUsesTickManager)
+		{
+			if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+			{
+				InteractionSubsystem->SetInteractorActive(*this, bShouldTick);
+			}
+		}
+		else
+		{
+			PrimaryComponentTick.SetTickFunctionEnable(bShouldTick);
+		}
 	}
 }
 
 void UVetInteractionComponent::OnRep_InteractionState(const FVetInteractionComponentState& InPreviousState)
 {
+	InteractionState.SetResolvedInteractingComponent(ResolveInteractiveHandle(InteractionState.GetInteractingHandle()));
+	UpdateWaitingForHandles();
+	OnRequestsAnswered();
+
+	//Updates about other interactions are applied as usual, the prediction is kept until
+	//the server answers it with its own key or rejects it.
+	if (PendingPredictionKey != 0 && InteractionState.GetPredictionKey() == PendingPredictionKey)
+	{
+		PendingPredictionKey = 0;
+		PredictedInteractingComponent = nullptr;
+
+		//Confirmed, the start events already fired when predicting.
+		if (InteractionState.IsInteracting())
+		{
+			return;
+		}
+	}
+
 	if (InPreviousState.IsInteracting() != InteractionState.IsInteracting()
 		|| InPreviousState.GetReplicationKey() != InteractionState.GetReplicationKey())
 	{
-		AActor* FocusedActor = InteractionState.GetFocusedActor();
-		UVetInteractiveComponent* CurrentInteractive = !IsValid(FocusedActor) ? nullptr : IVetInteractiveInterface::GetInteractiveComponent_Internal(FocusedActor);
+		AActor* InteractingActor = InteractionState.GetInteractingActor();
+		UVetInteractiveComponent* CurrentInteractive = !IsValid(InteractingActor) ? nullptr : IVetInteractiveInterface::GetInteractiveComponent_Internal(InteractingActor);
 
 		if (InteractionState.IsInteracting())
 		{
 			OnInteractionStarted.Broadcast(CurrentInteractive);
 			ConditionallySetTickEnabled(/*bInEnabled =*/ false);
+
+			//The input was released before the server started the interaction
+			if (bStopAfterStartRequest)
+			{
+				bStopAfterStartRequest = false;
+				StopInteraction();
+			}
 		}
 		else
 		{
@@ -439,11 +1494,147 @@ void UVetInteractionComponent::OnRep_InteractionState(const FVetInteractionCompo
 			ConditionallySetTickEnabled(/*bInEnabled =*/ true);
 		}
 	}
+}
+
+void UVetInteractionComponent::OnRep_FocusedHandle()
+{
+	SetFocusFromHandle(FocusedHandle);
+}
+
+void UVetInteractionComponent::OnRep_SharedFocusedHandle()
+{
+	//Other players never receive the owner only property, the shared copy is used as their focused component.
+	SetFocusFromHandle(SharedFocusedHandle);
+}
+
+void UVetInteractionComponent::SetFocusFromHandle(const FVetInteractiveHandle& InHandle)
+{
+	UPrimitiveComponent* const PreviousFocusedComponent = FocusedComponent;
+	const int32 PreviousFocusedInstanceIndex = FocusedInstanceIndex;
+	FocusedComponent = ResolveInteractiveHandle(InHandle);
+	FocusedInstanceIndex = FocusedComponent ? InHandle.GetInstanceIndex() : INDEX_NONE;
+	if (FocusedComponent != PreviousFocusedComponent || FocusedInstanceIndex != PreviousFocusedInstanceIndex)
+	{
+		SwitchFocusedComponent(FocusedComponent, FocusedInstanceIndex, PreviousFocusedComponent, PreviousFocusedInstanceIndex);
+	}
+
+	//Resolved again once the handle of its interactive is assigned
+	const UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	PendingFocusHandle = (FocusedComponent == nullptr && InteractionSubsystem && InteractionSubsystem->IsInteractiveHandlePending(InHandle))
+		? InHandle
+		: FVetInteractiveHandle();
+	UpdateWaitingForHandles();
+}
+
+void UVetInteractionComponent::ResolvePendingHandles()
+{
+	if (PendingFocusHandle.IsValid())
+	{
+		SetFocusFromHandle(PendingFocusHandle);
+	}
+
+	if (InteractionState.GetInteractingComponent() == nullptr && InteractionState.GetInteractingHandle().IsValid())
+	{
+		InteractionState.SetResolvedInteractingComponent(ResolveInteractiveHandle(InteractionState.GetInteractingHandle()));
+	}
+
+	UpdateWaitingForHandles();
+}
+
+void UVetInteractionComponent::UpdateWaitingForHandles()
+{
+	UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld());
+	if (InteractionSubsystem == nullptr)
+	{
+		return;
+	}
+
+	const bool bWaiting = PendingFocusHandle.IsValid()
+		|| (InteractionState.GetInteractingComponent() == nullptr && InteractionSubsystem->IsInteractiveHandlePending(InteractionState.GetInteractingHandle()));
+	if (bWaiting != bWaitingForHandles)
+	{
+		bWaitingForHandles = bWaiting;
+		InteractionSubsystem->SetWaitingForInteractiveHandles(*this, bWaiting);
+	}
+}
+
+void UVetInteractionComponent::OnRep_OwnedTags()
+{
+	//Forces the mask to be rebuilt
+	OwnedTagMaskFrame = MAX_uint64;
+}
+
+void UVetInteractionComponent::MarkInteractionStateDirty()
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME(UVetInteractionComponent, InteractionState, this);
+}
+
+bool UVetInteractionComponent::UpdatesFocusLocally() const
+{
+	if (IsFocusFromLocalPlayer())
+	{
+		return IsLocal();
+	}
+	if (FocusDetector != nullptr || TraceType == EVetInteractionTraceType::Proximity_Overlap)
+	{
+		return GetOwner()->HasAuthority();
+	}
+	return bClientAuthoritativeFocus ? IsLocallyControlled() : GetOwner()->HasAuthority();
+}
+
+bool UVetInteractionComponent::IsFocusFromLocalPlayer() const
+{
+	return FocusDetector != nullptr ? FocusDetector->RunsOnLocalPlayer() : TraceType == EVetInteractionTraceType::LineTrace_FromCursor;
+}
+
+bool UVetInteractionComponent::ValidateClientFocus(const UPrimitiveComponent& InFocusedComponent, int32 InFocusedInstanceIndex) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_ValidateClientFocus);
+
+	FVector StartLocation;
+	FVector EndLocation;
+	GetSphereTraceLocations(StartLocation, EndLocation);
+
+	FBox FocusedBounds = InFocusedComponent.Bounds.GetBox();
+
+	//The bounds of an instanced mesh cover every instance
+	if (InFocusedInstanceIndex != INDEX_NONE)
+	{
+		const UInstancedStaticMeshComponent* const InstancedMesh = Cast<UInstancedStaticMeshComponent>(&InFocusedComponent);
+		FTransform InstanceTransform;
+		if (InstancedMesh == nullptr || InstancedMesh->GetStaticMesh() == nullptr
+			|| !InstancedMesh->GetInstanceTransform(InFocusedInstanceIndex, InstanceTransform, /*bWorldSpace =*/ true))
+		{
+			return false;
+		}
+		FocusedBounds = InstancedMesh->GetStaticMesh()->GetBounds().GetBox().TransformBy(InstanceTransform);
+	}
+	const float MaxDistance = InteractionRadius + ClientFocusDistanceTolerance;
+
+	//Distance to the swept sphere
+	const FVector ClosestPointOnTrace = FMath::ClosestPointOnSegment(FocusedBounds.GetCenter(), StartLocation, EndLocation);
+	if (FocusedBounds.ComputeSquaredDistanceToPoint(ClosestPointOnTrace) > FMath::Square(MaxDistance))
+	{
+		return false;
+	}
+
+	//Angle, anything touching the sphere around the owner is accepted
+	const FVector TargetLocation = FocusedBounds.GetClosestPointTo(StartLocation);
+	const FVector ToTarget = TargetLocation - StartLocation;
+	if (ToTarget.SizeSquared() > FMath::Square(MaxDistance)
+		&& FVector::DotProduct(GetOwner()->GetActorForwardVector(), ToTarget.GetSafeNormal()) < FMath::Cos(FMath::DegreesToRadians(ClientFocusMaxAngle)))
+	{
+		return false;
+	}
 
-	if (InteractionState.GetFocusedComponent() != InPreviousState.GetFocusedComponent())
+	//Line of sight
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetInteractionValidateClientFocus), /*bTraceComplex =*/ false, GetOwner());
+	FHitResult HitResult;
+	if (GetWorld()->LineTraceSingleByChannel(HitResult, StartLocation, TargetLocation, TraceChannel, QueryParams))
 	{
-		SwitchFocusedComponent(InteractionState.GetFocusedComponent(), InPreviousState.GetFocusedComponent());
+		return HitResult.GetActor() == InFocusedComponent.GetOwner();
 	}
+	return true;
 }
 
 bool UVetInteractionComponent::IsLocal() const
@@ -473,5 +1664,29 @@ void UVetInteractionComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProper
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UVetInteractionComponent, InteractionState);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UVetInteractionComponent, InteractionState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UVetInteractionComponent, OwnedTags, Params);
+
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UVetInteractionComponent, FocusedHandle, Params);
+
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UVetInteractionComponent, SharedFocusedHandle, Params);
+}
+
+bool FVetInteractionComponentState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint8 Flags = (bIsInteracting ? 1 : 0) | (static_cast<uint8>(Result) << 1);
+	Ar.SerializeBits(&Flags, 2);
+	bIsInteracting = (Flags & 1) != 0;
+	Result = static_cast<EVetInteractionResult>((Flags >> 1) & 1);
+
+	Ar << ReplicationKey;
+	Ar << PredictionKey;
+
+	//Resolved by the interaction component once received
+	return InteractingHandle.NetSerialize(Ar, Map, bOutSuccess);
 }
\ No newline at end of file
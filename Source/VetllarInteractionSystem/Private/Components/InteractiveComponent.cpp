@@ -3,11 +3,16 @@
 #include "Components/InteractiveComponent.h"
 
 //Engine
+#include "Engine/World.h"
 #include "GameFramework/Actor.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Net/UnrealNetwork.h"
 
 //Interaction
 #include "Components/InteractionComponent.h"
+#include "InteractionSettings.h"
+#include "InteractionSubsystem.h"
 
 
 DEFINE_LOG_CATEGORY(LogVetInteractive);
@@ -18,6 +23,8 @@ UVetInteractiveComponent::UVetInteractiveComponent()
 	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	SetIsReplicatedByDefault(true);
+
+	InstanceStates.Owner = this;
 }
 
 bool UVetInteractiveComponent::CanBeFocusedOn(UVetInteractionComponent& InInteractor) const
@@ -28,9 +35,10 @@ bool UVetInteractiveComponent::CanBeFocusedOn(UVetInteractionComponent& InIntera
 	}
 
 	bool bResult = InteractiveState.InteractabilityState != EVetInteractability::Unavailable;
+	bResult = bResult && InteractiveConfig->GetFocusProgram().Evaluate(FVetConditionContext(InInteractor, *this));
 	if (InteractionPrerequisiteScript != nullptr)
 	{
-		bResult = bResult && InteractionPrerequisiteScript->CanBeFocusedOn(InInteractor);
+		bResult = bResult && InteractionPrerequisiteScript->CanBeFocusedOn_Internal(InInteractor);
 	}
 	return bResult;
 }
@@ -44,24 +52,45 @@ bool UVetInteractiveComponent::CanBeInteractedWith(UVetInteractionComponent& InI
 	}
 
 	bool bResult = InteractiveState.InteractabilityState == EVetInteractability::Available;
+	bResult = bResult && InteractiveConfig->GetInteractionProgram().Evaluate(FVetConditionContext(InInteractor, *this));
 	if (InteractionPrerequisiteScript != nullptr)
 	{
-		bResult = bResult && InteractionPrerequisiteScript->CanBeInteractedWith(InInteractor);
+		bResult = bResult && InteractionPrerequisiteScript->CanBeInteractedWith_Internal(InInteractor);
 	}
 	return bResult;
 }
 
-bool UVetInteractiveComponent::StartInteraction(UVetInteractionComponent& InInteractor, const FOnInteractionComplete& InCompleteDelegate, UPrimitiveComponent* InFocuedOnComponent)
+bool UVetInteractiveComponent::PassesTagFilter(const UVetInteractionComponent& InInteractor) const
+{
+	return InteractiveConfig == nullptr || InteractiveConfig->GetTagFilter().Passes(InInteractor);
+}
+
+bool UVetInteractiveComponent::StartInteraction(UVetInteractionComponent& InInteractor, const FOnInteractionComplete& InCompleteDelegate, UPrimitiveComponent* InFocuedOnComponent, int32 InFocusedOnInstanceIndex /*= INDEX_NONE*/)
 {
 	check(GetOwner()->HasAuthority());
 
-	if (!CanBeInteractedWith(InInteractor))
+	if (!CanBeInteractedWith(InInteractor)
+		|| (InFocusedOnInstanceIndex != INDEX_NONE && GetInstanceInteractability(InFocusedOnInstanceIndex) != EVetInteractability::Available))
 	{
 		return false;
 	}
 
+	InteractingInstanceIndex = InFocusedOnInstanceIndex;
+
+	if (InteractiveConfig->InteractionTime <= 0.0f)
+	{
+		OnInteractionComplete = InCompleteDelegate;
+		ExecuteInstantInteraction(InInteractor, InFocuedOnComponent, InFocusedOnInstanceIndex);
+		return true;
+	}
+
+	WakeFromNetDormancy();
+
 	CurrentInteractor = &InInteractor;
-	InteractiveState.SetIsBeingInteractedWith(true, InFocuedOnComponent);
+	InteractiveState.SetInteractionStartTime(GetServerWorldTime());
+	InteractiveState.SetIsBeingInteractedWith(true, InFocuedOnComponent, InFocusedOnInstanceIndex, InFocuedOnComponent ? GetPrimitiveIndex(*InFocuedOnComponent) : FVetInteractiveHandle::NoPrimitive);
+	MarkInteractiveStateDirty();
+	MarkInteractabilityDirty();
 
 	OnInteractionComplete = InCompleteDelegate;
 
@@ -75,16 +104,121 @@ void UVetInteractiveComponent::CancelInteraction()
 	EndInteraction_Internal();
 }
 
-void UVetInteractiveComponent::BeginFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent)
+void UVetInteractiveComponent::StartPredictedInteraction(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex /*= INDEX_NONE*/)
+{
+	check(!GetOwner()->HasAuthority());
+
+	CurrentInteractor = &InInteractor;
+	InteractingInstanceIndex = InFocusedOnInstanceIndex;
+	PredictedInteractionStartTime = GetServerWorldTime();
+	PredictedFocusedOnComponent = InFocusedOnComponent;
+
+	K2_OnInteractionStarted.Broadcast(&InInteractor, InFocusedOnComponent);
+}
+
+void UVetInteractiveComponent::CancelPredictedInteraction()
+{
+	if (PredictedInteractionStartTime < 0.0)
+	{
+		return;
+	}
+
+	PredictedInteractionStartTime = -1.0;
+	K2_OnInteractionEnded.Broadcast(CurrentInteractor.Get(), EVetInteractionResult::Cancelled, PredictedFocusedOnComponent.Get());
+	CurrentInteractor = nullptr;
+	PredictedFocusedOnComponent = nullptr;
+	InteractingInstanceIndex = InteractiveState.IsBeingInteractedWith() ? InteractiveState.GetFocusedOnInstanceIndex() : INDEX_NONE;
+}
+
+void UVetInteractiveComponent::BeginFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex)
 {
-	OnBeginFocusedOn(InInteractor, InFocusedOnComponent);
-	K2_OnBeginFocusedOn(&InInteractor, InFocusedOnComponent);
+	OnBeginFocusedOn(InInteractor, InFocusedOnComponent, InFocusedOnInstanceIndex);
+	K2_OnBeginFocusedOn(&InInteractor, InFocusedOnComponent, InFocusedOnInstanceIndex);
 }
 
-void UVetInteractiveComponent::EndFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent)
+void UVetInteractiveComponent::EndFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex)
 {
-	OnEndFocusedOn(InInteractor, InFocusedOnComponent);
-	K2_OnEndFocusedOn(&InInteractor,InFocusedOnComponent);
+	OnEndFocusedOn(InInteractor, InFocusedOnComponent, InFocusedOnInstanceIndex);
+	K2_OnEndFocusedOn(&InInteractor,InFocusedOnComponent, InFocusedOnInstanceIndex);
+}
+
+EVetInteractability UVetInteractiveComponent::GetInstanceInteractability(int32 InInstanceIndex) const
+{
+	const EVetInteractability InstanceState = InstanceInteractability.IsValidIndex(InInstanceIndex) ? InstanceInteractability[InInstanceIndex] : EVetInteractability::Available;
+
+	//States are sorted from most to least available
+	return static_cast<EVetInteractability>(FMath::Max(static_cast<uint8>(InstanceState), static_cast<uint8>(InteractiveState.InteractabilityState)));
+}
+
+void UVetInteractiveComponent::SetInstanceInteractability(int32 InInstanceIndex, EVetInteractability InInteractabilityState)
+{
+	check(GetOwner()->HasAuthority());
+
+	const EVetInteractability PrevState = InstanceInteractability.IsValidIndex(InInstanceIndex) ? InstanceInteractability[InInstanceIndex] : EVetInteractability::Available;
+	if (InInstanceIndex < 0 || PrevState == InInteractabilityState)
+	{
+		return;
+	}
+
+	if (!InstanceStateItemIndices.IsValidIndex(InInstanceIndex))
+	{
+		const int32 PrevNum = InstanceStateItemIndices.Num();
+		InstanceStateItemIndices.SetNumUninitialized(InInstanceIndex + 1);
+		for (int32 Index = PrevNum; Index < InstanceStateItemIndices.Num(); ++Index)
+		{
+			InstanceStateItemIndices[Index] = INDEX_NONE;
+		}
+	}
+
+	//Available instances are removed from the replicated list, keeping it as small as the number of unavailable instances.
+	const int32 ItemIndex = InstanceStateItemIndices[InInstanceIndex];
+	if (InInteractabilityState == EVetInteractability::Available)
+	{
+		const int32 LastItemIndex = InstanceStates.Items.Num() - 1;
+		if (ItemIndex != LastItemIndex)
+		{
+			InstanceStateItemIndices[InstanceStates.Items[LastItemIndex].InstanceIndex] = ItemIndex;
+		}
+		InstanceStates.Items.RemoveAtSwap(ItemIndex);
+		InstanceStateItemIndices[InInstanceIndex] = INDEX_NONE;
+		InstanceStates.MarkArrayDirty();
+	}
+	else if (ItemIndex == INDEX_NONE)
+	{
+		InstanceStateItemIndices[InInstanceIndex] = InstanceStates.Items.Num();
+		FVetInstanceStateItem& NewItem = InstanceStates.Items.AddDefaulted_GetRef();
+		NewItem.InstanceIndex = InInstanceIndex;
+		NewItem.InteractabilityState = InInteractabilityState;
+		InstanceStates.MarkItemDirty(NewItem);
+	}
+	else
+	{
+		FVetInstanceStateItem& Item = InstanceStates.Items[ItemIndex];
+		Item.InteractabilityState = InInteractabilityState;
+		InstanceStates.MarkItemDirty(Item);
+	}
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(UVetInteractiveComponent, InstanceStates, this);
+	NotifyNetActivity();
+
+	SetInstanceInteractability_Internal(InInstanceIndex, InInteractabilityState);
+}
+
+void UVetInteractiveComponent::SetInstanceInteractability_Internal(int32 InInstanceIndex, EVetInteractability InInteractabilityState)
+{
+	if (InInstanceIndex < 0)
+	{
+		return;
+	}
+
+	if (!InstanceInteractability.IsValidIndex(InInstanceIndex))
+	{
+		InstanceInteractability.SetNum(InInstanceIndex + 1);
+	}
+	InstanceInteractability[InInstanceIndex] = InInteractabilityState;
+
+	MarkInteractabilityDirty();
+	OnInstanceInteractabilityStateChanged.Broadcast(InInstanceIndex, InInteractabilityState);
 }
 
 void UVetInteractiveComponent::SetIsEnabled(bool bInNewEnabled)
@@ -98,22 +232,49 @@ void UVetInteractiveComponent::SetIsEnabled(bool bInNewEnabled)
 	}
 }
 
+void UVetInteractiveComponent::SetInteractiveConfig(UVetInteractiveConfig* InInteractiveConfig)
+{
+	if (InInteractiveConfig == InteractiveConfig)
+	{
+		return;
+	}
+
+	InteractiveConfig = InInteractiveConfig;
+
+	if (HasBegunPlay())
+	{
+		CreatePrerequisiteScript();
+		EvaluateInteractabilityState_Internal();
+	}
+}
+
+void UVetInteractiveComponent::MarkInteractabilityDirty()
+{
+	++InteractabilityVersion;
+
+	//Let interactors skipping traces know that something changed around them.
+	if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+	{
+		InteractionSubsystem->MarkInteractiveChanged(*this);
+	}
+}
+
 bool UVetInteractiveComponent::GetCurrentInteractionAsPercent(float& OutPercent) const
 {
-	if (InteractiveState.IsBeingInteractedWith() == false
+	if (IsBeingInteractedWith() == false
 		|| InteractiveConfig == nullptr || InteractiveConfig->InteractionTime <= 0.0f)
 	{
 		OutPercent = 0.0f;
 		return false;
 	}
 
-	OutPercent = InteractionElapsedTime / InteractiveConfig->InteractionTime;
+	OutPercent = GetInteractionElapsedTime() / InteractiveConfig->InteractionTime;
 	return true;
 }
 
 bool UVetInteractiveComponent::GetCurrentInteractionRemainingTime(float& OutRemainingTime, float& OutRequiredTime) const
 {
-	if (InteractiveState.IsBeingInteractedWith() == false
+	if (IsBeingInteractedWith() == false
 		|| InteractiveConfig == nullptr || InteractiveConfig->InteractionTime <= 0.0f)
 	{
 		OutRequiredTime = 0.0f;
@@ -122,7 +283,7 @@ bool UVetInteractiveComponent::GetCurrentInteractionRemainingTime(float& OutRema
 	}
 
 	OutRequiredTime = InteractiveConfig->InteractionTime;
-	OutRemainingTime =  OutRequiredTime - InteractionElapsedTime;
+	OutRemainingTime = OutRequiredTime - GetInteractionElapsedTime();
 	return true;
 	
 }
@@ -137,36 +298,253 @@ void UVetInteractiveComponent::BeginPlay()
 	}
 
 	EvaluateInteractabilityState_Internal();
+	CreatePrerequisiteScript();
+	BuildPrimitiveIndices();
 
-	if (IsValid(InteractiveConfig) &&  IsValid(InteractiveConfig->PrerequisitesScript))
+	//The state might have been received before the primitives were indexed
+	if (!GetOwner()->HasAuthority())
 	{
-		InteractionPrerequisiteScript = NewObject<UVetInteractivePrerequisiteScript>(this, InteractiveConfig->PrerequisitesScript, TEXT("Prerequisites Script"));
+		InteractiveState.ResolveFocusedOnComponent(*this);
+	}
+
+	if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+	{
+		InteractionSubsystem->RegisterInteractive(*this);
+
+		if (GetOwner()->HasAuthority())
+		{
+			Handle = InteractionSubsystem->AllocateInteractiveHandle(*this);
+			MARK_PROPERTY_DIRTY_FROM_NAME(UVetInteractiveComponent, Handle, this);
+		}
+		else
+		{
+			//The handle might have been received before begin play
+			InteractionSubsystem->AssignInteractiveHandle(*this, Handle);
+		}
 	}
+
+	AActor* const Owner = GetOwner();
+
+	//Initially dormant actors would never send the handle to clients
+	if (Owner->HasAuthority() && Owner->NetDormancy == DORM_Initial && GetIsReplicated())
+	{
+		Owner->FlushNetDormancy();
+	}
+
+	bManagesNetDormancy = Owner->HasAuthority()
+		&& GetIsReplicated()
+		&& bAllowNetDormancy
+		&& UVetInteractionSettings::Get().bManageInteractiveNetDormancy
+		&& Owner->NetDormancy != DORM_Never;
+
+	//Starts counting the idle time so the owner goes dormant if nobody interacts with it
+	NotifyNetActivity();
+}
+
+void UVetInteractiveComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+	{
+		if (ScheduledInteractionDeadline >= 0.0)
+		{
+			InteractionSubsystem->CancelInteractionTimer(*this, ScheduledInteractionDeadline);
+			ScheduledInteractionDeadline = -1.0;
+		}
+		InteractionSubsystem->UnregisterInteractive(*this);
+		InteractionSubsystem->ReleaseInteractiveHandle(*this, Handle);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UVetInteractiveComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	if (GetOwner()->HasAuthority()
-		&& (!InteractiveState.IsBeingInteractedWith() || !CurrentInteractor.IsValid()))
+	//Only used on the server when there is no interaction subsystem to complete timed interactions.
+	if (GetInteractionElapsedTime() >= InteractiveConfig->InteractionTime)
 	{
-		CancelInteraction();
+		OnInteractionTimerExpired();
+	}
+}
+
+bool UVetInteractiveComponent::GetCachedInteractabilityState(EVetInteractability& OutInteractabilityState) const
+{
+	const uint32 ConfigVersion = IsValid(InteractiveConfig) ? InteractiveConfig->GetVersion() : 0;
+	if (CachedInteractabilityVersion != InteractabilityVersion
+		|| CachedConfigVersion != ConfigVersion)
+	{
+		return false;
+	}
+
+	OutInteractabilityState = CachedInteractabilityState;
+	return true;
+}
+
+void UVetInteractiveComponent::SetCachedInteractabilityState(EVetInteractability InInteractabilityState)
+{
+	CachedInteractabilityState = InInteractabilityState;
+	CachedInteractabilityVersion = InteractabilityVersion;
+	CachedConfigVersion = IsValid(InteractiveConfig) ? InteractiveConfig->GetVersion() : 0;
+}
+
+void UVetInteractiveComponent::MarkInteractiveStateDirty()
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME(UVetInteractiveComponent, InteractiveState, this);
+	NotifyNetActivity();
+}
+
+void UVetInteractiveComponent::WakeFromNetDormancy()
+{
+	if (!bManagesNetDormancy)
+	{
+		return;
 	}
 
-	InteractionElapsedTime += DeltaTime;
-	if (InteractionElapsedTime >= InteractiveConfig->InteractionTime)
+	AActor* const Owner = GetOwner();
+	if (Owner->NetDormancy > DORM_Awake)
 	{
-		//Avoid it going over the max value, this is mostly to avoid issues on the client side.
-		InteractionElapsedTime = InteractiveConfig->InteractionTime;
+		Owner->SetNetDormancy(DORM_Awake);
+	}
 
-		//Call interaction ended events
-		CompleteInteraction_Internal();
+	NotifyNetActivity();
+}
+
+void UVetInteractiveComponent::NotifyNetActivity()
+{
+	if (!bManagesNetDormancy)
+	{
+		return;
+	}
+
+	AActor* const Owner = GetOwner();
+	if (Owner->NetDormancy > DORM_Awake)
+	{
+		//Sends the change once and keeps the owner dormant
+		Owner->FlushNetDormancy();
+		return;
+	}
+
+	LastNetActivityTime = GetWorld()->GetTimeSeconds();
+	if (!bDormancyTimerScheduled)
+	{
+		ScheduleDormancyTimer(LastNetActivityTime + UVetInteractionSettings::Get().NetDormancyIdleTime);
+	}
+}
+
+void UVetInteractiveComponent::ScheduleDormancyTimer(double InDeadline)
+{
+	if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+	{
+		InteractionSubsystem->ScheduleDormancyTimer(*this, InDeadline);
+		bDormancyTimerScheduled = true;
+	}
+}
+
+void UVetInteractiveComponent::OnDormancyTimerExpired()
+{
+	bDormancyTimerScheduled = false;
+
+	AActor* const Owner = GetOwner();
+	if (!bManagesNetDormancy || Owner->NetDormancy != DORM_Awake)
+	{
+		return;
+	}
+
+	const double IdleTime = UVetInteractionSettings::Get().NetDormancyIdleTime;
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	if (InteractiveState.IsBeingInteractedWith())
+	{
+		ScheduleDormancyTimer(CurrentTime + IdleTime);
+		return;
+	}
+
+	//Activity happened after the timer was scheduled
+	if (CurrentTime - LastNetActivityTime < IdleTime)
+	{
+		ScheduleDormancyTimer(LastNetActivityTime + IdleTime);
+		return;
+	}
+
+	Owner->SetNetDormancy(DORM_DormantAll);
+}
+
+bool UVetInteractiveComponent::HasReplicatedHandle() const
+{
+	return Handle.IsValid() && GetIsReplicated() && GetOwner()->GetIsReplicated();
+}
+
+uint8 UVetInteractiveComponent::GetPrimitiveIndex(const UPrimitiveComponent& InPrimitive) const
+{
+	if (InPrimitive.GetOwner() != GetOwner())
+	{
+		return FVetInteractiveHandle::NoPrimitive;
+	}
+
+	const int32 PrimitiveIndex = IndexedPrimitives.IndexOfByKey(&InPrimitive);
+	return PrimitiveIndex == INDEX_NONE ? FVetInteractiveHandle::NoPrimitive : static_cast<uint8>(PrimitiveIndex);
+}
+
+UPrimitiveComponent* UVetInteractiveComponent::GetPrimitiveAtIndex(uint8 InPrimitiveIndex) const
+{
+	if (!IndexedPrimitives.IsValidIndex(InPrimitiveIndex))
+	{
+		return nullptr;
+	}
+
+	UPrimitiveComponent* const Primitive = IndexedPrimitives[InPrimitiveIndex];
+	return IsValid(Primitive) ? Primitive : nullptr;
+}
+
+void UVetInteractiveComponent::BuildPrimitiveIndices()
+{
+	//Primitives created at runtime or only on some machines would shift the indices, those are referenced by object instead.
+	IndexedPrimitives.Reset();
+	GetOwner()->ForEachComponent<UPrimitiveComponent>(/*bIncludeFromChildActors =*/ false, [this](UPrimitiveComponent* InPrimitive)
+		{
+			if (InPrimitive->IsNameStableForNetworking())
+			{
+				IndexedPrimitives.Add(InPrimitive);
+			}
+		});
+
+	IndexedPrimitives.Sort([](const UPrimitiveComponent& InA, const UPrimitiveComponent& InB)
+		{
+			return InA.GetFName().LexicalLess(InB.GetFName());
+		});
+
+	if (IndexedPrimitives.Num() > FVetInteractiveHandle::NoPrimitive)
+	{
+		IndexedPrimitives.SetNum(FVetInteractiveHandle::NoPrimitive);
+	}
+}
+
+void UVetInteractiveComponent::OnRep_Handle()
+{
+	//Assigned on begin play instead if this arrives first
+	if (HasBegunPlay())
+	{
+		if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+		{
+			InteractionSubsystem->AssignInteractiveHandle(*this, Handle);
+		}
+	}
+}
+
+void UVetInteractiveComponent::CreatePrerequisiteScript()
+{
+	InteractionPrerequisiteScript = nullptr;
+
+	if (IsValid(InteractiveConfig) && IsValid(InteractiveConfig->PrerequisitesScript))
+	{
+		InteractionPrerequisiteScript = NewObject<UVetInteractivePrerequisiteScript>(this, InteractiveConfig->PrerequisitesScript, TEXT("Prerequisites Script"));
 	}
 }
 
 void UVetInteractiveComponent::EvaluateInteractabilityState_Internal()
 {
+	MarkInteractabilityDirty();
+
 	EVetInteractability PrevInteractabilityState = InteractiveState.InteractabilityState;
 	InteractiveState.InteractabilityState = EVetInteractability::Unavailable;
 	if (InteractiveConfig != nullptr)
@@ -183,14 +561,18 @@ void UVetInteractiveComponent::EvaluateInteractabilityState_Internal()
 
 	if (PrevInteractabilityState != InteractiveState.InteractabilityState)
 	{
+		MarkInteractiveStateDirty();
 		OnInteractabilityStateChanged.Broadcast(InteractiveState.InteractabilityState);
 	}
 }
 
 void UVetInteractiveComponent::OnRep_InteractiveState(const FVetInteractiveState& InPreviousState)
 {
+	InteractiveState.ResolveFocusedOnComponent(*this);
+
 	if (InteractiveState.InteractabilityState != InPreviousState.InteractabilityState)
 	{
+		MarkInteractabilityDirty();
 		OnInteractabilityStateChanged.Broadcast(InteractiveState.InteractabilityState);
 	}
 
@@ -199,7 +581,13 @@ void UVetInteractiveComponent::OnRep_InteractiveState(const FVetInteractiveState
 	{
 		if (InteractiveState.IsBeingInteractedWith())
 		{
-			OnInteractionStarted();
+			InteractingInstanceIndex = InteractiveState.GetFocusedOnInstanceIndex();
+
+			//A predicted interaction already triggered the start events.
+			if (PredictedInteractionStartTime < 0.0)
+			{
+				OnInteractionStarted();
+			}
 		}
 		else
 		{
@@ -212,23 +600,46 @@ void UVetInteractiveComponent::OnInteractionStarted()
 {
 	K2_OnInteractionStarted.Broadcast(CurrentInteractor.Get(), InteractiveState.GetFocusedOnComponent());
 
-	if (InteractiveConfig->InteractionTime > 0.0f)
+	if (!GetOwner()->HasAuthority())
 	{
-		PrimaryComponentTick.SetTickFunctionEnable(true);
+		//Clients compute the progress from the replicated start time, nothing to update.
+		return;
 	}
-	//If the interaction is instant and we are on the server, end the interaction instantly
-	else if (GetOwner()->HasAuthority())
+
+	//Only timed interactions get here, instant ones go through ExecuteInstantInteraction.
+	if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
 	{
-		CompleteInteraction_Internal();
+		ScheduledInteractionDeadline = InteractiveState.GetInteractionStartTime() + InteractiveConfig->InteractionTime;
+		InteractionSubsystem->ScheduleInteractionTimer(*this, ScheduledInteractionDeadline);
+	}
+	else
+	{
+		PrimaryComponentTick.SetTickFunctionEnable(true);
 	}
 }
 
 void UVetInteractiveComponent::OnInteractionEnded(EVetInteractionResult InResult)
 {
 	PrimaryComponentTick.SetTickFunctionEnable(false);
-	InteractionElapsedTime = 0.0f;
+	PredictedInteractionStartTime = -1.0;
+	PredictedFocusedOnComponent = nullptr;
+	if (ScheduledInteractionDeadline >= 0.0)
+	{
+		if (UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(GetWorld()))
+		{
+			InteractionSubsystem->CancelInteractionTimer(*this, ScheduledInteractionDeadline);
+		}
+		ScheduledInteractionDeadline = -1.0;
+	}
+	LastInteractionEndTime = GetWorld()->GetTimeSeconds();
 
 	K2_OnInteractionEnded.Broadcast(CurrentInteractor.Get(), InResult, InteractiveState.GetFocusedOnComponent());
+
+	//Clients only know the interactor when it was predicted locally
+	if (!GetOwner()->HasAuthority())
+	{
+		CurrentInteractor = nullptr;
+	}
 }
 
 void UVetInteractiveComponent::CompleteInteraction_Internal()
@@ -247,11 +658,191 @@ void UVetInteractiveComponent::EndInteraction_Internal()
 	OnInteractionEnded(InteractiveState.InteractionResult);
 	CurrentInteractor = nullptr;
 	InteractiveState.SetIsBeingInteractedWith(false);
+	MarkInteractiveStateDirty();
+	MarkInteractabilityDirty();
+}
+
+void UVetInteractiveComponent::ExecuteInstantInteraction(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex)
+{
+	K2_OnInteractionStarted.Broadcast(&InInteractor, InFocusedOnComponent);
+
+	OnInteractionComplete.ExecuteIfBound(*this);
+	OnInteractionComplete.Unbind();
+
+	LastInteractionEndTime = GetWorld()->GetTimeSeconds();
+	K2_OnInteractionEnded.Broadcast(&InInteractor, EVetInteractionResult::Success, InFocusedOnComponent);
+	MarkInteractabilityDirty();
+
+	//Multicasts are dropped while dormant
+	WakeFromNetDormancy();
+
+	++InstantInteractionSequence;
+	const uint8 FocusedOnPrimitiveIndex = InFocusedOnComponent ? GetPrimitiveIndex(*InFocusedOnComponent) : FVetInteractiveHandle::NoPrimitive;
+	Multicast_InstantInteraction(&InInteractor, FocusedOnPrimitiveIndex, InFocusedOnInstanceIndex, InstantInteractionSequence);
+}
+
+void UVetInteractiveComponent::Multicast_InstantInteraction_Implementation(UVetInteractionComponent* InInteractor, uint8 InFocusedOnPrimitiveIndex, int32 InFocusedOnInstanceIndex, uint8 InSequence)
+{
+	//The server already triggered the events
+	if (GetOwner()->HasAuthority())
+	{
+		return;
+	}
+
+	//Drop events older than the last one received, the sequence wraps around.
+	//The first event is always accepted since late joiners don't know the sequence of the server.
+	if (bReceivedInstantInteraction && static_cast<int8>(InSequence - InstantInteractionSequence) <= 0)
+	{
+		return;
+	}
+	bReceivedInstantInteraction = true;
+	InstantInteractionSequence = InSequence;
+
+	UPrimitiveComponent* const FocusedOnComponent = GetPrimitiveAtIndex(InFocusedOnPrimitiveIndex);
+	InteractingInstanceIndex = InFocusedOnInstanceIndex;
+	K2_OnInteractionStarted.Broadcast(InInteractor, FocusedOnComponent);
+	LastInteractionEndTime = GetWorld()->GetTimeSeconds();
+	K2_OnInteractionEnded.Broadcast(InInteractor, EVetInteractionResult::Success, FocusedOnComponent);
+
+	if (IsValid(InInteractor))
+	{
+		InInteractor->OnInstantInteractionReplicated(*this);
+	}
+}
+
+void UVetInteractiveComponent::OnInteractionTimerExpired()
+{
+	ScheduledInteractionDeadline = -1.0;
+
+	if (!InteractiveState.IsBeingInteractedWith())
+	{
+		return;
+	}
+
+	//The interactor went away during the interaction
+	if (!CurrentInteractor.IsValid())
+	{
+		CancelInteraction();
+		return;
+	}
+
+	CompleteInteraction_Internal();
+}
+
+float UVetInteractiveComponent::GetInteractionElapsedTime() const
+{
+	if (!IsBeingInteractedWith() || InteractiveConfig == nullptr)
+	{
+		return 0.0f;
+	}
+
+	const double StartTime = (PredictedInteractionStartTime >= 0.0) ? PredictedInteractionStartTime : InteractiveState.GetInteractionStartTime();
+	const double ElapsedTime = GetServerWorldTime() - StartTime;
+	return FMath::Clamp(static_cast<float>(ElapsedTime), 0.0f, InteractiveConfig->InteractionTime);
+}
+
+double UVetInteractiveComponent::GetServerWorldTime() const
+{
+	const UWorld* const World = GetWorld();
+	if (const AGameStateBase* const GameState = World->GetGameState())
+	{
+		return GameState->GetServerWorldTimeSeconds();
+	}
+	return World->GetTimeSeconds();
 }
 
 void  UVetInteractiveComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UVetInteractiveComponent, InteractiveState);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UVetInteractiveComponent, InteractiveState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UVetInteractiveComponent, InstanceStates, Params);
+
+	Params.Condition = COND_InitialOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UVetInteractiveComponent, Handle, Params);
+}
+
+bool FVetInteractiveState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	//2 bits for the interactability, 1 for the result and 1 for the interacting flag
+	uint8 Flags = static_cast<uint8>(InteractabilityState)
+		| (static_cast<uint8>(InteractionResult) << 2)
+		| ((bIsBeingInteractedWith ? 1 : 0) << 3);
+	Ar.SerializeBits(&Flags, 4);
+	InteractabilityState = static_cast<EVetInteractability>(FMath::Min<uint8>(Flags & 3, static_cast<uint8>(EVetInteractability::Unavailable)));
+	InteractionResult = static_cast<EVetInteractionResult>((Flags >> 2) & 1);
+	bIsBeingInteractedWith = ((Flags >> 3) & 1) != 0;
+
+	Ar << ReplicationKey;
+
+	//The start time is only meaningful during an interaction
+	if (bIsBeingInteractedWith)
+	{
+		Ar << InteractionStartTime;
+	}
+
+	//Indexed primitives go as their index like in interactive handles, anything else as an object reference.
+	Ar << FocusedOnPrimitiveIndex;
+	bOutSuccess = true;
+	if (FocusedOnPrimitiveIndex == FVetInteractiveHandle::NoPrimitive)
+	{
+		UObject* FocusedOnObject = FocuedOnComponent.Get();
+		bOutSuccess = Map->SerializeObject(Ar, UPrimitiveComponent::StaticClass(), FocusedOnObject);
+		if (Ar.IsLoading())
+		{
+			FocuedOnComponent = Cast<UPrimitiveComponent>(FocusedOnObject);
+		}
+	}
+	else if (Ar.IsLoading())
+	{
+		//See ResolveFocusedOnComponent
+		FocuedOnComponent = nullptr;
+	}
+
+	uint8 bHasInstance = FocusedOnInstanceIndex != INDEX_NONE ? 1 : 0;
+	Ar.SerializeBits(&bHasInstance, 1);
+
+	uint32 PackedInstanceIndex = bHasInstance ? static_cast<uint32>(FocusedOnInstanceIndex) : 0;
+	if (bHasInstance)
+	{
+		Ar.SerializeIntPacked(PackedInstanceIndex);
+	}
+
+	if (Ar.IsLoading())
+	{
+		FocusedOnInstanceIndex = bHasInstance ? static_cast<int32>(PackedInstanceIndex) : INDEX_NONE;
+	}
+	return bOutSuccess;
+}
+
+void FVetInteractiveState::ResolveFocusedOnComponent(const UVetInteractiveComponent& InInteractive)
+{
+	if (FocusedOnPrimitiveIndex != FVetInteractiveHandle::NoPrimitive)
+	{
+		FocuedOnComponent = InInteractive.GetPrimitiveAtIndex(FocusedOnPrimitiveIndex);
+	}
+}
+
+void FVetInstanceStateItem::PreReplicatedRemove(const FVetInstanceStateArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+	{
+		InArraySerializer.Owner->SetInstanceInteractability_Internal(InstanceIndex, EVetInteractability::Available);
+	}
+}
+
+void FVetInstanceStateItem::PostReplicatedAdd(const FVetInstanceStateArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+	{
+		InArraySerializer.Owner->SetInstanceInteractability_Internal(InstanceIndex, InteractabilityState);
+	}
+}
+
+void FVetInstanceStateItem::PostReplicatedChange(const FVetInstanceStateArray& InArraySerializer)
+{
+	PostReplicatedAdd(InArraySerializer);
 }
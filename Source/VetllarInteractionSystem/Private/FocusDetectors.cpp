@@ -0,0 +1,114 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+
+#include "FocusDetectors.h"
+
+//Engine
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "WorldCollision.h"
+
+//Interaction
+#include "Components/InteractionComponent.h"
+
+namespace VetFocusDetectors
+{
+	//Instance location for instanced mesh hits, component location otherwise.
+	FVector GetCandidateLocation(const FHitResult& InHitResult)
+	{
+		const UInstancedStaticMeshComponent* const InstancedMesh = Cast<UInstancedStaticMeshComponent>(InHitResult.GetComponent());
+		FTransform InstanceTransform;
+		if (InstancedMesh != nullptr && InHitResult.Item != INDEX_NONE
+			&& InstancedMesh->GetInstanceTransform(InHitResult.Item, InstanceTransform, /*bWorldSpace =*/ true))
+		{
+			return InstanceTransform.GetLocation();
+		}
+		return InHitResult.GetComponent()->GetComponentLocation();
+	}
+
+	void OverlapSphere(const FVetFocusQuery& InQuery, const FVector& InCenter, float InRadius, const FName& InStatName, TArray<FHitResult>& OutHitResults)
+	{
+		const FCollisionQueryParams QueryParams(InStatName, /*bTraceComplex =*/ false, &InQuery.Owner);
+		TArray<FOverlapResult> Overlaps;
+		InQuery.World.OverlapMultiByChannel(Overlaps, InCenter, FQuat::Identity, InQuery.TraceChannel, FCollisionShape::MakeSphere(InRadius), QueryParams);
+
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			if (UPrimitiveComponent* const Primitive = Overlap.GetComponent())
+			{
+				FHitResult& HitResult = OutHitResults.Emplace_GetRef(Overlap.GetActor(), Primitive, Primitive->Bounds.Origin, FVector::ZeroVector);
+				HitResult.Item = Overlap.ItemIndex;
+			}
+		}
+	}
+}
+
+FVetFocusQuery::FVetFocusQuery(const UVetInteractionComponent& InInteractor, bool bInFromTouch)
+	: Interactor(InInteractor)
+	, Owner(*InInteractor.GetOwner())
+	, World(*InInteractor.GetWorld())
+	, TraceChannel(InInteractor.GetTraceChannel())
+	, bFromTouch(bInFromTouch)
+{
+	InInteractor.GetViewPoint(ViewLocation, ViewDirection);
+}
+
+float UVetFocusDetector::ScoreCandidate(const FVetFocusQuery& InQuery, const FVector& InCandidateLocation) const
+{
+	return FVector::DistSquared(InCandidateLocation, InQuery.ViewLocation);
+}
+
+void UVetFocusDetector_SphereSweep::GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const
+{
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetFocusDetectorSphereSweep), /*bTraceComplex =*/ false, &InQuery.Owner);
+	const FVector StartLocation = InQuery.Owner.GetActorLocation();
+	const FVector EndLocation = StartLocation + (InQuery.Owner.GetActorForwardVector() * Distance);
+	InQuery.World.SweepMultiByChannel(OutHitResults, StartLocation, EndLocation, FQuat::Identity, InQuery.TraceChannel, FCollisionShape::MakeSphere(Radius), QueryParams);
+}
+
+void UVetFocusDetector_ViewCone::GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const
+{
+	VetFocusDetectors::OverlapSphere(InQuery, InQuery.ViewLocation, Range, SCENE_QUERY_STAT_NAME_ONLY(VetFocusDetectorViewCone), OutHitResults);
+
+	const float MinDot = FMath::Cos(FMath::DegreesToRadians(HalfAngle));
+	OutHitResults.RemoveAllSwap([&](const FHitResult& InHitResult)
+		{
+			const FVector ToCandidate = (VetFocusDetectors::GetCandidateLocation(InHitResult) - InQuery.ViewLocation).GetSafeNormal();
+			return FVector::DotProduct(InQuery.ViewDirection, ToCandidate) < MinDot;
+		});
+}
+
+float UVetFocusDetector_ViewCone::ScoreCandidate(const FVetFocusQuery& InQuery, const FVector& InCandidateLocation) const
+{
+	const FVector ToCandidate = InCandidateLocation - InQuery.ViewLocation;
+	const float Distance = ToCandidate.Size();
+	const float AngleScore = 1.0f - FVector::DotProduct(InQuery.ViewDirection, ToCandidate.GetSafeNormal());
+	const float DistanceScore = Range > 0.0f ? Distance / Range : 0.0f;
+	return (AngleScore * AngleWeight) + DistanceScore;
+}
+
+void UVetFocusDetector_Cursor::GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const
+{
+	APlayerController* const PC = InQuery.World.GetFirstPlayerController();
+	if (!IsValid(PC) || !PC->IsLocalController())
+	{
+		return;
+	}
+
+	FHitResult HitResult;
+	const bool bHit = InQuery.bFromTouch
+		? PC->GetHitResultUnderFinger(ETouchIndex::Touch1, InQuery.TraceChannel, bTraceComplex, HitResult)
+		: PC->GetHitResultUnderCursor(InQuery.TraceChannel, bTraceComplex, HitResult);
+
+	if (bHit)
+	{
+		OutHitResults.Add(HitResult);
+	}
+}
+
+void UVetFocusDetector_Overlap::GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const
+{
+	VetFocusDetectors::OverlapSphere(InQuery, InQuery.Owner.GetActorLocation(), Radius, SCENE_QUERY_STAT_NAME_ONLY(VetFocusDetectorOverlap), OutHitResults);
+}
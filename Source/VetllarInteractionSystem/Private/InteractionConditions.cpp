@@ -0,0 +1,235 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+
+#include "InteractionConditions.h"
+
+//Engine
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GenericTeamAgentInterface.h"
+
+//Interaction
+#include "Components/InteractionComponent.h"
+#include "Components/InteractiveComponent.h"
+#include "InteractionStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Evaluate Conditions"), STAT_VetInteraction_EvaluateConditions, STATGROUP_VetInteraction);
+
+namespace VetInteractionConditions
+{
+	//Team of the actor itself, pawns without one use the team of their controller.
+	FGenericTeamId GetTeam(const AActor* InActor)
+	{
+		const FGenericTeamId TeamId = FGenericTeamId::GetTeamIdentifier(InActor);
+		if (TeamId != FGenericTeamId::NoTeam)
+		{
+			return TeamId;
+		}
+
+		const APawn* const Pawn = Cast<APawn>(InActor);
+		return Pawn != nullptr ? FGenericTeamId::GetTeamIdentifier(Pawn->GetController()) : TeamId;
+	}
+}
+
+bool FVetConditionProgram::Evaluate(const FVetConditionContext& InContext) const
+{
+	if (Ops.IsEmpty())
+	{
+		return true;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_EvaluateConditions);
+
+	const AActor* const InteractorOwner = InContext.Interactor.GetOwner();
+	const AActor* const InteractiveOwner = InContext.Interactive.GetOwner();
+	if (!IsValid(InteractorOwner) || !IsValid(InteractiveOwner))
+	{
+		return false;
+	}
+
+	//Only gathered if a tag instruction is found
+	TOptional<FGameplayTagContainer> InteractorTags;
+
+	TArray<bool, TInlineAllocator<16>> Stack;
+	Stack.SetNumUninitialized(MaxStackDepth);
+	int32 StackTop = 0;
+
+	for (const FVetConditionOp& Op : Ops)
+	{
+		switch (Op.Type)
+		{
+		case FVetConditionOp::EType::HasTag:
+		{
+			if (!InteractorTags.IsSet())
+			{
+				InContext.Interactor.GetOwnedGameplayTags(InteractorTags.Emplace());
+			}
+			Stack[StackTop++] = Op.bFlag ? InteractorTags->HasTagExact(Op.Tag) : InteractorTags->HasTag(Op.Tag);
+			break;
+		}
+		case FVetConditionOp::EType::Distance:
+		{
+			Stack[StackTop++] = FVector::DistSquared(InteractorOwner->GetActorLocation(), InteractiveOwner->GetActorLocation()) <= Op.Value;
+			break;
+		}
+		case FVetConditionOp::EType::Facing:
+		{
+			const FVector ToInteractive = (InteractiveOwner->GetActorLocation() - InteractorOwner->GetActorLocation()).GetSafeNormal();
+			Stack[StackTop++] = FVector::DotProduct(InteractorOwner->GetActorForwardVector(), ToInteractive) >= Op.Value;
+			break;
+		}
+		case FVetConditionOp::EType::Cooldown:
+		{
+			const double LastInteractionEndTime = InContext.Interactive.GetLastInteractionEndTime();
+			Stack[StackTop++] = LastInteractionEndTime < 0.0
+				|| (InteractiveOwner->GetWorld()->GetTimeSeconds() - LastInteractionEndTime) >= Op.Value;
+			break;
+		}
+		case FVetConditionOp::EType::Team:
+		{
+			const FGenericTeamId InteractorTeam = VetInteractionConditions::GetTeam(InteractorOwner);
+			const bool bSameTeam = InteractorTeam != FGenericTeamId::NoTeam
+				&& InteractorTeam == VetInteractionConditions::GetTeam(InteractiveOwner);
+			Stack[StackTop++] = bSameTeam != Op.bFlag;
+			break;
+		}
+		case FVetConditionOp::EType::Native:
+		{
+			Stack[StackTop++] = Op.NativeCondition->Evaluate(InContext);
+			break;
+		}
+		case FVetConditionOp::EType::And:
+		case FVetConditionOp::EType::Or:
+		{
+			const bool bIsAnd = Op.Type == FVetConditionOp::EType::And;
+			bool bResult = bIsAnd;
+			for (int32 OperandIndex = StackTop - Op.OperandCount; OperandIndex < StackTop; ++OperandIndex)
+			{
+				bResult = bIsAnd ? (bResult && Stack[OperandIndex]) : (bResult || Stack[OperandIndex]);
+			}
+			StackTop -= Op.OperandCount;
+			Stack[StackTop++] = bResult;
+			break;
+		}
+		case FVetConditionOp::EType::Not:
+		{
+			Stack[StackTop - 1] = !Stack[StackTop - 1];
+			break;
+		}
+		}
+	}
+
+	check(StackTop == 1);
+	return Stack[0];
+}
+
+void FVetConditionProgram::Reset()
+{
+	Ops.Reset();
+	StackDepth = 0;
+	MaxStackDepth = 0;
+}
+
+FVetConditionOp& FVetConditionProgram::AddOp(FVetConditionOp::EType InType, uint16 InOperandCount /*= 0*/)
+{
+	FVetConditionOp& NewOp = Ops.AddDefaulted_GetRef();
+	NewOp.Type = InType;
+
+	switch (InType)
+	{
+	case FVetConditionOp::EType::And:
+	case FVetConditionOp::EType::Or:
+		NewOp.OperandCount = InOperandCount;
+		StackDepth += 1 - InOperandCount;
+		break;
+	case FVetConditionOp::EType::Not:
+		break;
+	default:
+		++StackDepth;
+		break;
+	}
+
+	MaxStackDepth = FMath::Max(MaxStackDepth, StackDepth);
+	return NewOp;
+}
+
+void FVetConditionProgram::CompileList(const TArray<TObjectPtr<UVetInteractionCondition>>& InConditions, FVetConditionOp::EType InJoinType)
+{
+	uint16 NumCompiled = 0;
+	for (const UVetInteractionCondition* const Condition : InConditions)
+	{
+		if (IsValid(Condition))
+		{
+			Condition->Compile(*this);
+			++NumCompiled;
+		}
+	}
+
+	//A single condition is its own result. An empty And pushes true and an empty Or pushes false.
+	if (NumCompiled != 1)
+	{
+		AddOp(InJoinType, NumCompiled);
+	}
+}
+
+void UVetInteractionCondition_HasTag::Compile(FVetConditionProgram& OutProgram) const
+{
+	FVetConditionOp& Op = OutProgram.AddOp(FVetConditionOp::EType::HasTag);
+	Op.Tag = Tag;
+	Op.bFlag = bExactMatch;
+}
+
+void UVetInteractionCondition_Distance::Compile(FVetConditionProgram& OutProgram) const
+{
+	FVetConditionOp& Op = OutProgram.AddOp(FVetConditionOp::EType::Distance);
+	Op.Value = FMath::Square(MaxDistance);
+}
+
+void UVetInteractionCondition_Facing::Compile(FVetConditionProgram& OutProgram) const
+{
+	FVetConditionOp& Op = OutProgram.AddOp(FVetConditionOp::EType::Facing);
+	Op.Value = FMath::Cos(FMath::DegreesToRadians(MaxAngle));
+}
+
+void UVetInteractionCondition_Cooldown::Compile(FVetConditionProgram& OutProgram) const
+{
+	FVetConditionOp& Op = OutProgram.AddOp(FVetConditionOp::EType::Cooldown);
+	Op.Value = Cooldown;
+}
+
+void UVetInteractionCondition_Team::Compile(FVetConditionProgram& OutProgram) const
+{
+	FVetConditionOp& Op = OutProgram.AddOp(FVetConditionOp::EType::Team);
+	Op.bFlag = !bRequireSameTeam;
+}
+
+void UVetInteractionCondition_And::Compile(FVetConditionProgram& OutProgram) const
+{
+	OutProgram.CompileList(Conditions, FVetConditionOp::EType::And);
+}
+
+void UVetInteractionCondition_Or::Compile(FVetConditionProgram& OutProgram) const
+{
+	OutProgram.CompileList(Conditions, FVetConditionOp::EType::Or);
+}
+
+void UVetInteractionCondition_Not::Compile(FVetConditionProgram& OutProgram) const
+{
+	//Nothing to negate, always pass.
+	if (!IsValid(Condition))
+	{
+		OutProgram.AddOp(FVetConditionOp::EType::And);
+		return;
+	}
+
+	Condition->Compile(OutProgram);
+	OutProgram.AddOp(FVetConditionOp::EType::Not);
+}
+
+void UVetInteractionCondition_Native::Compile(FVetConditionProgram& OutProgram) const
+{
+	FVetConditionOp& Op = OutProgram.AddOp(FVetConditionOp::EType::Native);
+	Op.NativeCondition = this;
+}
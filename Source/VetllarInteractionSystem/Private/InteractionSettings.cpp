@@ -0,0 +1,10 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+
+#include "InteractionSettings.h"
+
+UVetInteractionSettings::UVetInteractionSettings()
+{
+	CategoryName = TEXT("Plugins");
+	SectionName = TEXT("Vetllar Interaction");
+}
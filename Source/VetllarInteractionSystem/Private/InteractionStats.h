@@ -0,0 +1,9 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+#pragma once
+
+//Engine
+#include "Stats/Stats.h"
+
+//Use "stat VetInteraction" to display these on screen (or in the logs of a headless server).
+DECLARE_STATS_GROUP(TEXT("VetInteraction"), STATGROUP_VetInteraction, STATCAT_Advanced);
@@ -0,0 +1,1206 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+
+#include "InteractionSubsystem.h"
+
+//Engine
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+//Interaction
+#include "Components/InteractionComponent.h"
+#include "Components/InteractiveComponent.h"
+#include "InteractionSettings.h"
+#include "InteractionStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spatial Index Query"), STAT_VetInteraction_SpatialIndexQuery, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Spatial Index Update"), STAT_VetInteraction_SpatialIndexUpdate, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Tick Manager"), STAT_VetInteraction_TickManager, STATGROUP_VetInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Managed Interactors Updated"), STAT_VetInteraction_ManagedInteractorsUpdated, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Batched Focus Sweeps"), STAT_VetInteraction_BatchedFocusSweeps, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Apply Batched Focus"), STAT_VetInteraction_ApplyBatchedFocus, STATGROUP_VetInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Focus Queries"), STAT_VetInteraction_BatchedFocusQueries, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Interaction Timers"), STAT_VetInteraction_InteractionTimers, STATGROUP_VetInteraction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Interaction Timers"), STAT_VetInteraction_ActiveInteractionTimers, STATGROUP_VetInteraction);
+DECLARE_CYCLE_STAT(TEXT("Lightweight Interactives"), STAT_VetInteraction_LightweightInteractives, STATGROUP_VetInteraction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Promoted Lightweight Interactives"), STAT_VetInteraction_PromotedLightweightInteractives, STATGROUP_VetInteraction);
+
+namespace VetInteractionSubsystem
+{
+	//Primitives covering more cells than this are tested on every query instead of being added to the grid.
+	constexpr int32 MaxCellsPerEntry = 64;
+
+	//Empty cells are removed at most this often, see PurgeEmptyCells.
+	constexpr double EmptyCellPurgeInterval = 10.0;
+
+	//Timer wheel layout. A full turn of the wheel covers NumTimerSlots * TimerSlotDuration seconds,
+	//timers further away than that stay in their slot until the wheel comes around again.
+	constexpr int32 NumTimerSlots = 256;
+	constexpr double TimerSlotDuration = 1.0 / 30.0;
+
+	//Lightweight interactive flags
+	constexpr uint8 LightweightAlive = 1 << 0;
+	constexpr uint8 LightweightEnabled = 1 << 1;
+	constexpr uint8 LightweightPromoted = 1 << 2;
+}
+
+void UVetInteractionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CellSize = FMath::Max(UVetInteractionSettings::Get().SpatialIndexCellSize, 1.0f);
+
+	TimerWheel.SetNum(VetInteractionSubsystem::NumTimerSlots);
+}
+
+void UVetInteractionSubsystem::Deinitialize()
+{
+	for (FIndexEntry& Entry : Entries)
+	{
+		if (UPrimitiveComponent* const Primitive = Entry.Primitive.Get())
+		{
+			Primitive->TransformUpdated.Remove(Entry.TransformUpdatedHandle);
+		}
+	}
+
+	Entries.Empty();
+	Cells.Empty();
+	EmptiedCells.Empty();
+	OversizedEntries.Empty();
+	InteractiveEntries.Empty();
+	ActorInteractives.Empty();
+	PrimitiveEntries.Empty();
+	ManagedInteractors.Empty();
+	ManagedInteractorIndices.Empty();
+	BatchedFocusQueries.Empty();
+	NumBatchedFocusQueries = 0;
+	TimerWheel.Empty();
+	HandleSlots.Empty();
+	FreeHandleSlots.Empty();
+	InteractorsWaitingForHandles.Empty();
+
+	LightweightTransforms.Empty();
+	LightweightClassIndices.Empty();
+	LightweightGenerations.Empty();
+	LightweightFlags.Empty();
+	LightweightLastNearbyTimes.Empty();
+	LightweightInstanceStates.Empty();
+	FreeLightweightIndices.Empty();
+	LightweightActorClasses.Empty();
+	LightweightCells.Empty();
+	PromotingInteractors.Empty();
+
+	DEC_DWORD_STAT_BY(STAT_VetInteraction_PromotedLightweightInteractives, PromotedActors.Num());
+	PromotedActors.Empty();
+	PromotedActorIndices.Empty();
+
+	DEC_DWORD_STAT_BY(STAT_VetInteraction_ActiveInteractionTimers, NumInteractionTimers);
+	NumInteractionTimers = 0;
+
+	Super::Deinitialize();
+}
+
+void UVetInteractionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	TickInteractionTimers(CurrentTime);
+	PurgeEmptyCells(CurrentTime);
+
+	//Promoted before focus is updated so interactors can find the new actors right away
+	TickLightweightInteractives(CurrentTime);
+	TickManagedInteractors(DeltaTime, CurrentTime);
+}
+
+void UVetInteractionSubsystem::TickManagedInteractors(float InDeltaTime, double InCurrentTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_TickManager);
+
+	const int32 NumInteractors = ManagedInteractors.Num();
+	if (NumInteractors == 0)
+	{
+		return;
+	}
+
+	const UVetInteractionSettings& Settings = UVetInteractionSettings::Get();
+	const double BudgetEndTime = FPlatformTime::Seconds() + (Settings.TickManagerBudgetMs / 1000.0);
+
+	//Enough interactors are always updated to go through all of them within the max staleness,
+	//even if that means going over budget.
+	const float StalenessFraction = FMath::Min(InDeltaTime / FMath::Max(Settings.TickManagerMaxStaleness, UE_KINDA_SMALL_NUMBER), 1.0f);
+	const int32 MinUpdates = FMath::CeilToInt32(NumInteractors * StalenessFraction);
+
+	int32 NumVisited = 0;
+	int32 NumUpdated = 0;
+	while (NumVisited < NumInteractors)
+	{
+		//The pending batch runs after the loop, its estimated cost is charged up front.
+		if (NumUpdated >= MinUpdates && FPlatformTime::Seconds() + (NumBatchedFocusQueries * BatchedFocusQueryCost) >= BudgetEndTime)
+		{
+			break;
+		}
+
+		NextManagedInteractor = NextManagedInteractor % NumInteractors;
+		FManagedInteractor& Managed = ManagedInteractors[NextManagedInteractor++];
+		++NumVisited;
+
+		UVetInteractionComponent* const Interactor = Managed.Interactor.Get();
+		if (!IsValid(Interactor)
+			|| (InCurrentTime - Managed.LastUpdateTime) < Interactor->PrimaryComponentTick.TickInterval)
+		{
+			continue;
+		}
+
+		Managed.LastUpdateTime = InCurrentTime;
+		++NumUpdated;
+
+		if (!Settings.bParallelFocusUpdates || !Interactor->CanBatchFocusUpdate())
+		{
+			Interactor->UpdateFocus();
+		}
+		else if (Interactor->PrepareFocusUpdate())
+		{
+			//Only the snapshot is taken now, the sweep and the focus are charged through the batch cost.
+			if (BatchedFocusQueries.Num() <= NumBatchedFocusQueries)
+			{
+				BatchedFocusQueries.AddDefaulted();
+			}
+
+			FBatchedFocusQuery& Query = BatchedFocusQueries[NumBatchedFocusQueries++];
+			Query.Interactor = Interactor;
+			Query.Owner = Interactor->GetOwner();
+			Query.Radius = Interactor->InteractionRadius;
+			Query.TraceChannel = Interactor->TraceChannel;
+			Interactor->GetSphereTraceLocations(Query.StartLocation, Query.EndLocation);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_VetInteraction_ManagedInteractorsUpdated, NumUpdated);
+
+	if (NumBatchedFocusQueries > 0)
+	{
+		RunBatchedFocusQueries();
+	}
+
+	//Interactors deactivated during the updates left their entries empty.
+	//The cursor moves back with every entry removed before it so no interactor is skipped.
+	int32 WriteIndex = 0;
+	int32 NewNextManagedInteractor = NextManagedInteractor;
+	for (int32 ReadIndex = 0; ReadIndex < ManagedInteractors.Num(); ++ReadIndex)
+	{
+		FManagedInteractor& Managed = ManagedInteractors[ReadIndex];
+		if (!Managed.Interactor.IsValid())
+		{
+			//Destroyed without being deactivated
+			if (!Managed.Interactor.IsExplicitlyNull())
+			{
+				ManagedInteractorIndices.Remove(Managed.Interactor);
+			}
+
+			if (ReadIndex < NextManagedInteractor)
+			{
+				--NewNextManagedInteractor;
+			}
+			continue;
+		}
+
+		if (WriteIndex != ReadIndex)
+		{
+			ManagedInteractorIndices.Add(Managed.Interactor, WriteIndex);
+			ManagedInteractors[WriteIndex] = MoveTemp(Managed);
+		}
+		++WriteIndex;
+	}
+
+	ManagedInteractors.SetNum(WriteIndex, /*bAllowShrinking =*/ false);
+	NextManagedInteractor = NewNextManagedInteractor;
+}
+
+void UVetInteractionSubsystem::RunBatchedFocusQueries()
+{
+	INC_DWORD_STAT_BY(STAT_VetInteraction_BatchedFocusQueries, NumBatchedFocusQueries);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	//Scene queries are safe to run from worker threads, nothing else is touched until the batch is done.
+	{
+		SCOPE_CYCLE_COUNTER(STAT_VetInteraction_BatchedFocusSweeps);
+
+		const UWorld* const World = GetWorld();
+		const EParallelForFlags ParallelForFlags = NumBatchedFocusQueries < UVetInteractionSettings::Get().ParallelFocusMinBatchSize
+			? EParallelForFlags::ForceSingleThread
+			: EParallelForFlags::None;
+
+		ParallelFor(NumBatchedFocusQueries, [&](int32 InQueryIndex)
+			{
+				FBatchedFocusQuery& Query = BatchedFocusQueries[InQueryIndex];
+				const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetInteractionBatchedFocusSweep), /*bTraceComplex =*/ false, Query.Owner);
+				World->SweepMultiByChannel(Query.HitResults, Query.StartLocation, Query.EndLocation, FQuat::Identity, Query.TraceChannel, FCollisionShape::MakeSphere(Query.Radius), QueryParams);
+			}, ParallelForFlags);
+	}
+
+	//Filtering can call into blueprints and focus changes broadcast events, both stay on the game thread.
+	{
+		SCOPE_CYCLE_COUNTER(STAT_VetInteraction_ApplyBatchedFocus);
+
+		for (int32 QueryIndex = 0; QueryIndex < NumBatchedFocusQueries; ++QueryIndex)
+		{
+			FBatchedFocusQuery& Query = BatchedFocusQueries[QueryIndex];
+			if (IsValid(Query.Interactor) && !Query.Interactor->IsInteractingOrPredicting())
+			{
+				Query.Interactor->SetFocusFromHitResults(Query.HitResults);
+			}
+
+			Query.Interactor = nullptr;
+			Query.Owner = nullptr;
+			Query.HitResults.Reset();
+		}
+	}
+
+	BatchedFocusQueryCost = (FPlatformTime::Seconds() - StartTime) / NumBatchedFocusQueries;
+	NumBatchedFocusQueries = 0;
+}
+
+void UVetInteractionSubsystem::TickInteractionTimers(double InCurrentTime)
+{
+	const int64 CurrentWheelTick = GetTimerWheelTick(InCurrentTime);
+	if (NumInteractionTimers == 0)
+	{
+		LastTimerWheelTick = CurrentWheelTick;
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_InteractionTimers);
+
+	//The last slot is visited again since timers in it might have a deadline later than the last tick.
+	//If more than a full turn passed every slot is visited once.
+	const int64 NumSlotsToVisit = FMath::Min<int64>(CurrentWheelTick - LastTimerWheelTick + 1, VetInteractionSubsystem::NumTimerSlots);
+	LastTimerWheelTick = CurrentWheelTick;
+
+	TArray<FInteractionTimer, TInlineAllocator<8>> ExpiredTimers;
+	for (int64 WheelTick = CurrentWheelTick - NumSlotsToVisit + 1; WheelTick <= CurrentWheelTick; ++WheelTick)
+	{
+		TArray<FInteractionTimer>& Slot = TimerWheel[WheelTick & (VetInteractionSubsystem::NumTimerSlots - 1)];
+		for (int32 TimerIndex = Slot.Num() - 1; TimerIndex >= 0; --TimerIndex)
+		{
+			if (Slot[TimerIndex].Deadline <= InCurrentTime)
+			{
+				ExpiredTimers.Emplace(Slot[TimerIndex]);
+				Slot.RemoveAtSwap(TimerIndex, 1, /*bAllowShrinking =*/ false);
+			}
+		}
+	}
+
+	NumInteractionTimers -= ExpiredTimers.Num();
+	DEC_DWORD_STAT_BY(STAT_VetInteraction_ActiveInteractionTimers, ExpiredTimers.Num());
+
+	//Notified once the wheel is consistent again, completing an interaction might schedule a new timer.
+	for (const FInteractionTimer& ExpiredTimer : ExpiredTimers)
+	{
+		UVetInteractiveComponent* const Interactive = ExpiredTimer.Interactive.Get();
+		if (Interactive == nullptr)
+		{
+			continue;
+		}
+
+		switch (ExpiredTimer.Type)
+		{
+		case ETimerType::InteractionDeadline:
+			Interactive->OnInteractionTimerExpired();
+			break;
+		case ETimerType::Dormancy:
+			Interactive->OnDormancyTimerExpired();
+			break;
+		}
+	}
+}
+
+TStatId UVetInteractionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVetInteractionSubsystem, STATGROUP_Tickables);
+}
+
+void UVetInteractionSubsystem::SetInteractorActive(UVetInteractionComponent& InInteractor, bool bInActive)
+{
+	const TWeakObjectPtr<UVetInteractionComponent> Interactor(&InInteractor);
+	const int32* const ManagedIndex = ManagedInteractorIndices.Find(Interactor);
+
+	if (bInActive && ManagedIndex == nullptr)
+	{
+		ManagedInteractorIndices.Add(Interactor, ManagedInteractors.Num());
+		FManagedInteractor& NewManaged = ManagedInteractors.AddDefaulted_GetRef();
+		NewManaged.Interactor = Interactor;
+	}
+	else if (!bInActive && ManagedIndex != nullptr)
+	{
+		//Removed after the tick, this might be called while the interactors are being updated.
+		ManagedInteractors[*ManagedIndex].Interactor = nullptr;
+		ManagedInteractorIndices.Remove(Interactor);
+	}
+}
+
+void UVetInteractionSubsystem::RegisterInteractor(UVetInteractionComponent& InInteractor)
+{
+	PromotingInteractors.AddUnique(&InInteractor);
+}
+
+void UVetInteractionSubsystem::UnregisterInteractor(UVetInteractionComponent& InInteractor)
+{
+	PromotingInteractors.RemoveSwap(&InInteractor);
+}
+
+FVetLightweightInteractiveId UVetInteractionSubsystem::AddLightweightInteractive(const FTransform& InTransform, TSubclassOf<AActor> InActorClass)
+{
+	if (InActorClass == nullptr)
+	{
+		return FVetLightweightInteractiveId();
+	}
+
+	const int32 ClassIndex = LightweightActorClasses.AddUnique(InActorClass);
+	check(ClassIndex <= MAX_uint16);
+
+	int32 Index = INDEX_NONE;
+	if (FreeLightweightIndices.Num() > 0)
+	{
+		Index = FreeLightweightIndices.Pop(/*bAllowShrinking =*/ false);
+		LightweightTransforms[Index] = InTransform;
+	}
+	else
+	{
+		Index = LightweightTransforms.Add(InTransform);
+		LightweightClassIndices.AddZeroed();
+		LightweightGenerations.AddZeroed();
+		LightweightFlags.AddZeroed();
+		LightweightLastNearbyTimes.AddZeroed();
+	}
+
+	LightweightClassIndices[Index] = static_cast<uint16>(ClassIndex);
+	++LightweightGenerations[Index];
+	LightweightFlags[Index] = VetInteractionSubsystem::LightweightAlive | VetInteractionSubsystem::LightweightEnabled;
+	LightweightLastNearbyTimes[Index] = 0.0;
+
+	LightweightCells.FindOrAdd(GetCellCoordinates(InTransform.GetLocation())).Add(Index);
+
+	FVetLightweightInteractiveId NewId;
+	NewId.Index = Index;
+	NewId.Generation = LightweightGenerations[Index];
+	return NewId;
+}
+
+void UVetInteractionSubsystem::RemoveLightweightInteractive(FVetLightweightInteractiveId InId)
+{
+	if (!IsValidLightweightId(InId))
+	{
+		return;
+	}
+
+	const int32 Index = InId.Index;
+	TWeakObjectPtr<AActor> PromotedActor;
+	if (PromotedActors.RemoveAndCopyValue(Index, PromotedActor))
+	{
+		DEC_DWORD_STAT(STAT_VetInteraction_PromotedLightweightInteractives);
+		if (AActor* const Actor = PromotedActor.Get())
+		{
+			PromotedActorIndices.Remove(Actor);
+			Actor->OnDestroyed.RemoveDynamic(this, &UVetInteractionSubsystem::OnPromotedActorDestroyed);
+			Actor->Destroy();
+		}
+	}
+
+	if (TArray<int32>* const CellEntries = LightweightCells.Find(GetCellCoordinates(LightweightTransforms[Index].GetLocation())))
+	{
+		CellEntries->RemoveSwap(Index);
+	}
+
+	LightweightFlags[Index] = 0;
+	LightweightInstanceStates.Remove(Index);
+	FreeLightweightIndices.Add(Index);
+}
+
+void UVetInteractionSubsystem::SetLightweightInteractiveEnabled(FVetLightweightInteractiveId InId, bool bInEnabled)
+{
+	if (!IsValidLightweightId(InId))
+	{
+		return;
+	}
+
+	if (bInEnabled)
+	{
+		LightweightFlags[InId.Index] |= VetInteractionSubsystem::LightweightEnabled;
+	}
+	else
+	{
+		LightweightFlags[InId.Index] &= ~VetInteractionSubsystem::LightweightEnabled;
+	}
+
+	if (AActor* const PromotedActor = GetPromotedActor(InId))
+	{
+		if (UVetInteractiveComponent* const Interactive = FindInteractiveComponent(*PromotedActor))
+		{
+			Interactive->SetIsEnabled(bInEnabled);
+		}
+	}
+}
+
+bool UVetInteractionSubsystem::IsLightweightInteractiveEnabled(FVetLightweightInteractiveId InId) const
+{
+	return IsValidLightweightId(InId) && (LightweightFlags[InId.Index] & VetInteractionSubsystem::LightweightEnabled) != 0;
+}
+
+AActor* UVetInteractionSubsystem::GetPromotedActor(FVetLightweightInteractiveId InId) const
+{
+	if (!IsValidLightweightId(InId))
+	{
+		return nullptr;
+	}
+
+	const TWeakObjectPtr<AActor>* const PromotedActor = PromotedActors.Find(InId.Index);
+	return PromotedActor ? PromotedActor->Get() : nullptr;
+}
+
+bool UVetInteractionSubsystem::IsValidLightweightId(FVetLightweightInteractiveId InId) const
+{
+	return LightweightFlags.IsValidIndex(InId.Index)
+		&& (LightweightFlags[InId.Index] & VetInteractionSubsystem::LightweightAlive) != 0
+		&& LightweightGenerations[InId.Index] == InId.Generation;
+}
+
+void UVetInteractionSubsystem::TickLightweightInteractives(double InCurrentTime)
+{
+	//Promoted actors replicate to clients, only the server promotes.
+	if (GetNumLightweightInteractives() == 0 || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_LightweightInteractives);
+
+	PromotingInteractors.RemoveAllSwap([](const TWeakObjectPtr<UVetInteractionComponent>& InInteractor)
+		{
+			return !InInteractor.IsValid();
+		});
+
+	TArray<FVector> InteractorLocations;
+	InteractorLocations.Reserve(PromotingInteractors.Num());
+	for (const TWeakObjectPtr<UVetInteractionComponent>& Interactor : PromotingInteractors)
+	{
+		InteractorLocations.Add(Interactor->GetOwner()->GetActorLocation());
+	}
+
+	const UVetInteractionSettings& Settings = UVetInteractionSettings::Get();
+	const float PromotionRadius = Settings.LightweightPromotionRadius;
+
+	//Each interactor searches the cells around it in parallel, the results are applied on the game thread afterwards.
+	TArray<TArray<int32>> NearbyPerInteractor;
+	NearbyPerInteractor.SetNum(InteractorLocations.Num());
+	ParallelFor(InteractorLocations.Num(), [&](int32 InInteractorIndex)
+		{
+			const FVector& Center = InteractorLocations[InInteractorIndex];
+			const FIntVector MinCell = GetCellCoordinates(Center - FVector(PromotionRadius));
+			const FIntVector MaxCell = GetCellCoordinates(Center + FVector(PromotionRadius));
+			TArray<int32>& Nearby = NearbyPerInteractor[InInteractorIndex];
+
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+				{
+					for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+					{
+						const TArray<int32>* const CellEntries = LightweightCells.Find(FIntVector(X, Y, Z));
+						if (CellEntries == nullptr)
+						{
+							continue;
+						}
+
+						for (const int32 Index : *CellEntries)
+						{
+							if ((LightweightFlags[Index] & VetInteractionSubsystem::LightweightEnabled) != 0
+								&& FVector::DistSquared(LightweightTransforms[Index].GetLocation(), Center) <= FMath::Square(PromotionRadius))
+							{
+								Nearby.Add(Index);
+							}
+						}
+					}
+				}
+			}
+		});
+
+	for (const TArray<int32>& Nearby : NearbyPerInteractor)
+	{
+		for (const int32 Index : Nearby)
+		{
+			LightweightLastNearbyTimes[Index] = InCurrentTime;
+			if ((LightweightFlags[Index] & VetInteractionSubsystem::LightweightPromoted) == 0)
+			{
+				PromoteLightweightInteractive(Index, InCurrentTime);
+			}
+		}
+	}
+
+	TArray<int32, TInlineAllocator<16>> IndicesToDemote;
+	for (const TPair<int32, TWeakObjectPtr<AActor>>& Promoted : PromotedActors)
+	{
+		if (InCurrentTime - LightweightLastNearbyTimes[Promoted.Key] < Settings.LightweightDemotionDelay)
+		{
+			continue;
+		}
+
+		//Never demoted in the middle of an interaction
+		const AActor* const Actor = Promoted.Value.Get();
+		const UVetInteractiveComponent* const Interactive = Actor ? FindInteractiveComponent(*Actor) : nullptr;
+		if (Interactive != nullptr && Interactive->IsBeingInteractedWith())
+		{
+			LightweightLastNearbyTimes[Promoted.Key] = InCurrentTime;
+			continue;
+		}
+
+		IndicesToDemote.Add(Promoted.Key);
+	}
+
+	for (const int32 Index : IndicesToDemote)
+	{
+		DemoteLightweightInteractive(Index);
+	}
+}
+
+void UVetInteractionSubsystem::PromoteLightweightInteractive(int32 InIndex, double InCurrentTime)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* const Actor = GetWorld()->SpawnActor<AActor>(LightweightActorClasses[LightweightClassIndices[InIndex]], LightweightTransforms[InIndex], SpawnParameters);
+	if (Actor == nullptr)
+	{
+		//Disabled so it is not retried every frame
+		UE_LOG(LogVetInteractive, Warning, TEXT("Failed to promote lightweight interactive %d, it has been disabled."), InIndex);
+		LightweightFlags[InIndex] &= ~VetInteractionSubsystem::LightweightEnabled;
+		return;
+	}
+
+	//Restores what gameplay did to the instances the last time this was promoted
+	if (const TArray<TPair<int32, EVetInteractability>>* const InstanceStates = LightweightInstanceStates.Find(InIndex))
+	{
+		if (UVetInteractiveComponent* const Interactive = FindInteractiveComponent(*Actor))
+		{
+			for (const TPair<int32, EVetInteractability>& InstanceState : *InstanceStates)
+			{
+				Interactive->SetInstanceInteractability(InstanceState.Key, InstanceState.Value);
+			}
+		}
+	}
+
+	LightweightFlags[InIndex] |= VetInteractionSubsystem::LightweightPromoted;
+	PromotedActors.Add(InIndex, Actor);
+	PromotedActorIndices.Add(Actor, InIndex);
+	Actor->OnDestroyed.AddDynamic(this, &UVetInteractionSubsystem::OnPromotedActorDestroyed);
+	INC_DWORD_STAT(STAT_VetInteraction_PromotedLightweightInteractives);
+
+	FVetLightweightInteractiveId Id;
+	Id.Index = InIndex;
+	Id.Generation = LightweightGenerations[InIndex];
+	OnLightweightInteractivePromoted.Broadcast(Id, *Actor);
+}
+
+void UVetInteractionSubsystem::DemoteLightweightInteractive(int32 InIndex)
+{
+	TWeakObjectPtr<AActor> PromotedActor;
+	if (!PromotedActors.RemoveAndCopyValue(InIndex, PromotedActor))
+	{
+		return;
+	}
+
+	DEC_DWORD_STAT(STAT_VetInteraction_PromotedLightweightInteractives);
+	LightweightFlags[InIndex] &= ~VetInteractionSubsystem::LightweightPromoted;
+
+	if (AActor* const Actor = PromotedActor.Get())
+	{
+		//Keeps whatever gameplay did to the actor while it was promoted
+		if (const UVetInteractiveComponent* const Interactive = FindInteractiveComponent(*Actor))
+		{
+			if (!Interactive->bEnabled)
+			{
+				LightweightFlags[InIndex] &= ~VetInteractionSubsystem::LightweightEnabled;
+			}
+
+			TArray<TPair<int32, EVetInteractability>> InstanceStates;
+			InstanceStates.Reserve(Interactive->InstanceStates.Items.Num());
+			for (const FVetInstanceStateItem& Item : Interactive->InstanceStates.Items)
+			{
+				InstanceStates.Emplace(Item.InstanceIndex, Item.InteractabilityState);
+			}
+
+			if (InstanceStates.IsEmpty())
+			{
+				LightweightInstanceStates.Remove(InIndex);
+			}
+			else
+			{
+				LightweightInstanceStates.Add(InIndex, MoveTemp(InstanceStates));
+			}
+		}
+
+		PromotedActorIndices.Remove(Actor);
+		Actor->OnDestroyed.RemoveDynamic(this, &UVetInteractionSubsystem::OnPromotedActorDestroyed);
+		Actor->Destroy();
+	}
+
+	FVetLightweightInteractiveId Id;
+	Id.Index = InIndex;
+	Id.Generation = LightweightGenerations[InIndex];
+	OnLightweightInteractiveDemoted.Broadcast(Id);
+}
+
+void UVetInteractionSubsystem::OnPromotedActorDestroyed(AActor* InDestroyedActor)
+{
+	int32 Index = INDEX_NONE;
+	if (!PromotedActorIndices.RemoveAndCopyValue(InDestroyedActor, Index))
+	{
+		return;
+	}
+
+	PromotedActors.Remove(Index);
+	DEC_DWORD_STAT(STAT_VetInteraction_PromotedLightweightInteractives);
+	LightweightFlags[Index] &= ~VetInteractionSubsystem::LightweightPromoted;
+
+	FVetLightweightInteractiveId Id;
+	Id.Index = Index;
+	Id.Generation = LightweightGenerations[Index];
+	RemoveLightweightInteractive(Id);
+}
+
+void UVetInteractionSubsystem::RegisterInteractive(UVetInteractiveComponent& InInteractive)
+{
+	AActor* const Owner = InInteractive.GetOwner();
+	if (!IsValid(Owner) || InteractiveEntries.Contains(&InInteractive))
+	{
+		return;
+	}
+
+	TArray<int32>& InteractiveEntryIndices = InteractiveEntries.Add(&InInteractive);
+
+	//Resolved once here so the interface never has to search the actor for its interactive.
+	//Actors with more than one interactive are left to the interface to pick the right one.
+	if (TWeakObjectPtr<UVetInteractiveComponent>* const ActorInteractive = ActorInteractives.Find(Owner))
+	{
+		ActorInteractive->Reset();
+	}
+	else
+	{
+		ActorInteractives.Add(Owner, &InInteractive);
+	}
+
+	//Collision settings can change at runtime so they are checked during queries instead.
+	TInlineComponentArray<UPrimitiveComponent*> Primitives(Owner);
+	for (UPrimitiveComponent* const Primitive : Primitives)
+	{
+		if (!IsValid(Primitive) || PrimitiveEntries.Contains(Primitive))
+		{
+			continue;
+		}
+
+		FIndexEntry NewEntry;
+		NewEntry.Interactive = &InInteractive;
+		NewEntry.Primitive = Primitive;
+		NewEntry.PrimitiveKey = Primitive;
+		NewEntry.Bounds = Primitive->Bounds;
+
+		const int32 EntryIndex = Entries.Add(MoveTemp(NewEntry));
+
+		//Only movable primitives can change their bounds after registration.
+		if (Primitive->Mobility == EComponentMobility::Movable)
+		{
+			Entries[EntryIndex].TransformUpdatedHandle = Primitive->TransformUpdated.AddUObject(this, &UVetInteractionSubsystem::OnPrimitiveTransformUpdated);
+		}
+
+		AddEntryToCells(EntryIndex);
+		PrimitiveEntries.Add(Primitive, EntryIndex);
+		InteractiveEntryIndices.Add(EntryIndex);
+	}
+}
+
+void UVetInteractionSubsystem::UnregisterInteractive(UVetInteractiveComponent& InInteractive)
+{
+	TArray<int32> InteractiveEntryIndices;
+	if (!InteractiveEntries.RemoveAndCopyValue(&InInteractive, InteractiveEntryIndices))
+	{
+		return;
+	}
+
+	if (AActor* const Owner = InInteractive.GetOwner())
+	{
+		if (FindInteractiveComponent(*Owner) == &InInteractive)
+		{
+			ActorInteractives.Remove(Owner);
+		}
+	}
+
+	for (const int32 EntryIndex : InteractiveEntryIndices)
+	{
+		FIndexEntry& Entry = Entries[EntryIndex];
+		if (UPrimitiveComponent* const Primitive = Entry.Primitive.Get())
+		{
+			Primitive->TransformUpdated.Remove(Entry.TransformUpdatedHandle);
+		}
+
+		RemoveEntryFromCells(EntryIndex);
+		PrimitiveEntries.Remove(Entry.PrimitiveKey);
+		Entries.RemoveAt(EntryIndex);
+	}
+}
+
+void UVetInteractionSubsystem::QueryInteractivePrimitives(const FVector& InStart, const FVector& InEnd, float InRadius, ECollisionChannel InTraceChannel, const AActor* InIgnoredActor, TArray<UPrimitiveComponent*>& OutPrimitives)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_SpatialIndexQuery);
+
+	++QueryStamp;
+
+	const FBox QueryBox(InStart.ComponentMin(InEnd) - FVector(InRadius), InStart.ComponentMax(InEnd) + FVector(InRadius));
+
+	const auto& TestEntry([&](int32 InEntryIndex)
+		{
+			FIndexEntry& Entry = Entries[InEntryIndex];
+			if (Entry.LastQueryStamp == QueryStamp)
+			{
+				return;
+			}
+			Entry.LastQueryStamp = QueryStamp;
+
+			UPrimitiveComponent* const Primitive = Entry.Primitive.Get();
+			if (!IsValid(Primitive)
+				|| Primitive->GetOwner() == InIgnoredActor
+				|| !Primitive->IsQueryCollisionEnabled()
+				|| Primitive->GetCollisionResponseToChannel(InTraceChannel) == ECR_Ignore)
+			{
+				return;
+			}
+
+			if (!QueryBox.Intersect(Entry.Bounds.GetBox()))
+			{
+				return;
+			}
+
+			//Swept sphere against the bounding sphere of the primitive
+			const FVector ClosestPoint = FMath::ClosestPointOnSegment(Entry.Bounds.Origin, InStart, InEnd);
+			if (FVector::DistSquared(ClosestPoint, Entry.Bounds.Origin) > FMath::Square(InRadius + Entry.Bounds.SphereRadius))
+			{
+				return;
+			}
+
+			OutPrimitives.Add(Primitive);
+		});
+
+	const FIntVector MinCell = GetCellCoordinates(QueryBox.Min);
+	const FIntVector MaxCell = GetCellCoordinates(QueryBox.Max);
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				if (const FCell* const Cell = Cells.Find(FIntVector(X, Y, Z)))
+				{
+					for (const int32 EntryIndex : Cell->Entries)
+					{
+						TestEntry(EntryIndex);
+					}
+				}
+			}
+		}
+	}
+
+	for (const int32 EntryIndex : OversizedEntries)
+	{
+		TestEntry(EntryIndex);
+	}
+}
+
+void UVetInteractionSubsystem::MarkInteractiveChanged(UVetInteractiveComponent& InInteractive)
+{
+	if (const TArray<int32>* const InteractiveEntryIndices = InteractiveEntries.Find(&InInteractive))
+	{
+		for (const int32 EntryIndex : *InteractiveEntryIndices)
+		{
+			TouchEntryCells(EntryIndex);
+		}
+	}
+}
+
+uint32 UVetInteractionSubsystem::GetRegionVersion(const FBox& InRegion) const
+{
+	uint32 RegionVersion = OversizedVersion;
+
+	const FIntVector MinCell = GetCellCoordinates(InRegion.Min);
+	const FIntVector MaxCell = GetCellCoordinates(InRegion.Max);
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				if (const FCell* const Cell = Cells.Find(FIntVector(X, Y, Z)))
+				{
+					RegionVersion = FMath::Max(RegionVersion, Cell->Version);
+				}
+			}
+		}
+	}
+	return RegionVersion;
+}
+
+void UVetInteractionSubsystem::ScheduleInteractionTimer(UVetInteractiveComponent& InInteractive, double InDeadline)
+{
+	AddTimer(InInteractive, InDeadline, ETimerType::InteractionDeadline);
+}
+
+void UVetInteractionSubsystem::CancelInteractionTimer(UVetInteractiveComponent& InInteractive, double InDeadline)
+{
+	const int64 WheelTick = FMath::Max(GetTimerWheelTick(InDeadline), LastTimerWheelTick);
+
+	const int32 NumRemoved = TimerWheel[WheelTick & (VetInteractionSubsystem::NumTimerSlots - 1)].RemoveAllSwap([&InInteractive](const FInteractionTimer& InTimer)
+		{
+			return InTimer.Type == ETimerType::InteractionDeadline && InTimer.Interactive.Get() == &InInteractive;
+		}, /*bAllowShrinking =*/ false);
+
+	NumInteractionTimers -= NumRemoved;
+	DEC_DWORD_STAT_BY(STAT_VetInteraction_ActiveInteractionTimers, NumRemoved);
+}
+
+void UVetInteractionSubsystem::ScheduleDormancyTimer(UVetInteractiveComponent& InInteractive, double InDeadline)
+{
+	AddTimer(InInteractive, InDeadline, ETimerType::Dormancy);
+}
+
+FVetInteractiveHandle UVetInteractionSubsystem::AllocateInteractiveHandle(UVetInteractiveComponent& InInteractive)
+{
+	int32 SlotIndex = INDEX_NONE;
+	if (FreeHandleSlots.Num() > 0)
+	{
+		SlotIndex = FreeHandleSlots.Pop(/*bAllowShrinking =*/ false);
+	}
+	else if (HandleSlots.Num() <= MAX_uint16)
+	{
+		SlotIndex = HandleSlots.AddDefaulted();
+	}
+	else
+	{
+		UE_LOG(LogVetInteractive, Error, TEXT("Out of interactive handles, %s::%s can't be referenced over the network!"), *InInteractive.GetOwner()->GetName(), *InInteractive.GetName());
+		return FVetInteractiveHandle();
+	}
+
+	FHandleSlot& Slot = HandleSlots[SlotIndex];
+	Slot.Interactive = &InInteractive;
+	Slot.Generation = (Slot.Generation == MAX_uint16) ? 1 : Slot.Generation + 1;
+	return FVetInteractiveHandle(static_cast<uint16>(SlotIndex), Slot.Generation);
+}
+
+void UVetInteractionSubsystem::AssignInteractiveHandle(UVetInteractiveComponent& InInteractive, const FVetInteractiveHandle& InHandle)
+{
+	if (!InHandle.IsValid())
+	{
+		return;
+	}
+
+	if (!HandleSlots.IsValidIndex(InHandle.GetIndex()))
+	{
+		HandleSlots.SetNum(InHandle.GetIndex() + 1);
+	}
+
+	//A newer interactive can take the slot before the old one is destroyed on this client.
+	FHandleSlot& Slot = HandleSlots[InHandle.GetIndex()];
+	Slot.Interactive = &InInteractive;
+	Slot.Generation = InHandle.GetGeneration();
+
+	//Copied since interactors stop waiting while resolving
+	if (!InteractorsWaitingForHandles.IsEmpty())
+	{
+		const TArray<TWeakObjectPtr<UVetInteractionComponent>> WaitingInteractors = InteractorsWaitingForHandles;
+		for (const TWeakObjectPtr<UVetInteractionComponent>& WaitingInteractor : WaitingInteractors)
+		{
+			if (UVetInteractionComponent* const Interactor = WaitingInteractor.Get())
+			{
+				Interactor->ResolvePendingHandles();
+			}
+		}
+		InteractorsWaitingForHandles.RemoveAllSwap([](const TWeakObjectPtr<UVetInteractionComponent>& InInteractor) { return !InInteractor.IsValid(); });
+	}
+}
+
+void UVetInteractionSubsystem::ReleaseInteractiveHandle(UVetInteractiveComponent& InInteractive, const FVetInteractiveHandle& InHandle)
+{
+	if (!InHandle.IsValid() || !HandleSlots.IsValidIndex(InHandle.GetIndex()))
+	{
+		return;
+	}
+
+	FHandleSlot& Slot = HandleSlots[InHandle.GetIndex()];
+	if (Slot.Generation != InHandle.GetGeneration() || Slot.Interactive != &InInteractive)
+	{
+		return;
+	}
+
+	//The generation is kept so the next handle of this slot gets a new one
+	Slot.Interactive = nullptr;
+	if (InInteractive.GetOwner()->HasAuthority())
+	{
+		FreeHandleSlots.Add(InHandle.GetIndex());
+	}
+}
+
+UVetInteractiveComponent* UVetInteractionSubsystem::ResolveInteractiveHandle(const FVetInteractiveHandle& InHandle) const
+{
+	if (!InHandle.IsValid() || !HandleSlots.IsValidIndex(InHandle.GetIndex()))
+	{
+		return nullptr;
+	}
+
+	const FHandleSlot& Slot = HandleSlots[InHandle.GetIndex()];
+	return Slot.Generation == InHandle.GetGeneration() ? Slot.Interactive.Get() : nullptr;
+}
+
+bool UVetInteractionSubsystem::IsInteractiveHandlePending(const FVetInteractiveHandle& InHandle) const
+{
+	if (!InHandle.IsValid())
+	{
+		return false;
+	}
+
+	if (!HandleSlots.IsValidIndex(InHandle.GetIndex()))
+	{
+		return true;
+	}
+
+	//Generations wrap around skipping 0, a newer generation than the slot's means the interactive didn't arrive yet.
+	//The same generation without an interactive means it was already destroyed.
+	const FHandleSlot& Slot = HandleSlots[InHandle.GetIndex()];
+	return Slot.Generation == 0 || static_cast<int16>(InHandle.GetGeneration() - Slot.Generation) > 0;
+}
+
+void UVetInteractionSubsystem::SetWaitingForInteractiveHandles(UVetInteractionComponent& InInteractor, bool bInWaiting)
+{
+	if (bInWaiting)
+	{
+		InteractorsWaitingForHandles.AddUnique(&InInteractor);
+	}
+	else
+	{
+		InteractorsWaitingForHandles.RemoveSwap(&InInteractor);
+	}
+}
+
+FVetInteractiveHandle UVetInteractionSubsystem::MakePrimitiveHandle(UPrimitiveComponent* InPrimitive) const
+{
+	if (!IsValid(InPrimitive) || InPrimitive->GetOwner() == nullptr)
+	{
+		return FVetInteractiveHandle();
+	}
+
+	//Indexed primitives know their interactive even if the actor has more than one
+	const int32* const EntryIndex = PrimitiveEntries.Find(InPrimitive);
+	const UVetInteractiveComponent* const Interactive = EntryIndex ? Entries[*EntryIndex].Interactive.Get() : FindInteractiveComponent(*InPrimitive->GetOwner());
+	if (Interactive == nullptr)
+	{
+		return FVetInteractiveHandle();
+	}
+
+	const uint8 PrimitiveIndex = Interactive->GetPrimitiveIndex(*InPrimitive);
+	if (Interactive->HasReplicatedHandle() && PrimitiveIndex != FVetInteractiveHandle::NoPrimitive)
+	{
+		return Interactive->GetHandle().WithPrimitive(PrimitiveIndex);
+	}
+
+	//Level placed and default subobject primitives can still be referenced by path
+	return InPrimitive->IsSupportedForNetworking() ? FVetInteractiveHandle(InPrimitive) : FVetInteractiveHandle();
+}
+
+UPrimitiveComponent* UVetInteractionSubsystem::ResolvePrimitiveHandle(const FVetInteractiveHandle& InHandle) const
+{
+	if (!InHandle.IsValid())
+	{
+		return InHandle.GetPrimitive();
+	}
+
+	const UVetInteractiveComponent* const Interactive = ResolveInteractiveHandle(InHandle);
+	return Interactive ? Interactive->GetPrimitiveAtIndex(InHandle.GetPrimitiveIndex()) : nullptr;
+}
+
+bool UVetInteractionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UVetInteractionSubsystem::AddEntryToCells(int32 InEntryIndex)
+{
+	FIndexEntry& Entry = Entries[InEntryIndex];
+
+	const FBox Box = Entry.Bounds.GetBox();
+	Entry.MinCell = GetCellCoordinates(Box.Min);
+	Entry.MaxCell = GetCellCoordinates(Box.Max);
+
+	const FIntVector Span = Entry.MaxCell - Entry.MinCell + FIntVector(1);
+	Entry.bOversized = (int64)Span.X * Span.Y * Span.Z > VetInteractionSubsystem::MaxCellsPerEntry;
+	if (Entry.bOversized)
+	{
+		OversizedEntries.Add(InEntryIndex);
+		OversizedVersion = ++LastVersion;
+		return;
+	}
+
+	for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+	{
+		for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+		{
+			for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+			{
+				FCell& Cell = Cells.FindOrAdd(FIntVector(X, Y, Z));
+				Cell.Entries.Add(InEntryIndex);
+				Cell.Version = ++LastVersion;
+			}
+		}
+	}
+}
+
+void UVetInteractionSubsystem::RemoveEntryFromCells(int32 InEntryIndex)
+{
+	const FIndexEntry& Entry = Entries[InEntryIndex];
+	if (Entry.bOversized)
+	{
+		OversizedEntries.RemoveSwap(InEntryIndex);
+		OversizedVersion = ++LastVersion;
+		return;
+	}
+
+	//Empty cells are kept until the next purge so their version does not go back right away.
+	for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+	{
+		for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+		{
+			for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+			{
+				const FIntVector CellCoordinates(X, Y, Z);
+				if (FCell* const Cell = Cells.Find(CellCoordinates))
+				{
+					Cell->Entries.RemoveSwap(InEntryIndex);
+					Cell->Version = ++LastVersion;
+					if (Cell->Entries.IsEmpty())
+					{
+						EmptiedCells.Add(CellCoordinates);
+					}
+				}
+			}
+		}
+	}
+}
+
+void UVetInteractionSubsystem::PurgeEmptyCells(double InCurrentTime)
+{
+	if (EmptiedCells.IsEmpty()
+		|| (InCurrentTime - LastEmptyCellPurgeTime) < VetInteractionSubsystem::EmptyCellPurgeInterval)
+	{
+		return;
+	}
+
+	LastEmptyCellPurgeTime = InCurrentTime;
+
+	bool bRemovedAny = false;
+	for (const FIntVector& CellCoordinates : EmptiedCells)
+	{
+		const FCell* const Cell = Cells.Find(CellCoordinates);
+		if (Cell != nullptr && Cell->Entries.IsEmpty())
+		{
+			Cells.Remove(CellCoordinates);
+			bRemovedAny = true;
+		}
+	}
+	EmptiedCells.Reset();
+
+	//Regions covering a removed cell could go back to a version seen before the cell was emptied,
+	//so every region version changes once per purge instead of once per emptied cell.
+	if (bRemovedAny)
+	{
+		Cells.Compact();
+		OversizedVersion = ++LastVersion;
+	}
+}
+
+void UVetInteractionSubsystem::TouchEntryCells(int32 InEntryIndex)
+{
+	const FIndexEntry& Entry = Entries[InEntryIndex];
+	if (Entry.bOversized)
+	{
+		OversizedVersion = ++LastVersion;
+		return;
+	}
+
+	for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+	{
+		for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+		{
+			for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+			{
+				if (FCell* const Cell = Cells.Find(FIntVector(X, Y, Z)))
+				{
+					Cell->Version = ++LastVersion;
+				}
+			}
+		}
+	}
+}
+
+void UVetInteractionSubsystem::OnPrimitiveTransformUpdated(USceneComponent* InUpdatedComponent, EUpdateTransformFlags InUpdateTransformFlags, ETeleportType InTeleport)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VetInteraction_SpatialIndexUpdate);
+
+	const int32* const EntryIndex = PrimitiveEntries.Find(InUpdatedComponent);
+	if (EntryIndex == nullptr)
+	{
+		return;
+	}
+
+	FIndexEntry& Entry = Entries[*EntryIndex];
+	Entry.Bounds = CastChecked<UPrimitiveComponent>(InUpdatedComponent)->Bounds;
+
+	//Only touch the grid if the primitive moved to a different set of cells
+	const FBox Box = Entry.Bounds.GetBox();
+	if (Entry.bOversized
+		|| GetCellCoordinates(Box.Min) != Entry.MinCell
+		|| GetCellCoordinates(Box.Max) != Entry.MaxCell)
+	{
+		RemoveEntryFromCells(*EntryIndex);
+		AddEntryToCells(*EntryIndex);
+	}
+	else
+	{
+		TouchEntryCells(*EntryIndex);
+	}
+}
+
+FIntVector UVetInteractionSubsystem::GetCellCoordinates(const FVector& InLocation) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(InLocation.X / CellSize),
+		FMath::FloorToInt32(InLocation.Y / CellSize),
+		FMath::FloorToInt32(InLocation.Z / CellSize));
+}
+
+int64 UVetInteractionSubsystem::GetTimerWheelTick(double InTime) const
+{
+	return FMath::FloorToInt64(InTime / VetInteractionSubsystem::TimerSlotDuration);
+}
+
+void UVetInteractionSubsystem::AddTimer(UVetInteractiveComponent& InInteractive, double InDeadline, ETimerType InType)
+{
+	//Deadlines in the past fire on the next tick.
+	const int64 WheelTick = FMath::Max(GetTimerWheelTick(InDeadline), LastTimerWheelTick);
+
+	FInteractionTimer& NewTimer = TimerWheel[WheelTick & (VetInteractionSubsystem::NumTimerSlots - 1)].AddDefaulted_GetRef();
+	NewTimer.Interactive = &InInteractive;
+	NewTimer.Deadline = InDeadline;
+	NewTimer.Type = InType;
+
+	++NumInteractionTimers;
+	INC_DWORD_STAT(STAT_VetInteraction_ActiveInteractionTimers);
+}
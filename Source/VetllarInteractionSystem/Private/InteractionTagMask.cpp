@@ -0,0 +1,110 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+
+#include "InteractionTagMask.h"
+
+//Interaction
+#include "Components/InteractionComponent.h"
+#include "InteractionStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tag Filter Rejections"), STAT_VetInteraction_TagFilterRejections, STATGROUP_VetInteraction);
+
+namespace VetInteractionTagMask
+{
+	//Bit assigned to each tag used by a filter. Only accessed from the game thread.
+	TMap<FGameplayTag, int32>& GetTagBits()
+	{
+		static TMap<FGameplayTag, int32> TagBits;
+		return TagBits;
+	}
+}
+
+FVetInteractionTagMask FVetInteractionTagMask::MakeOwnedMask(const FGameplayTagContainer& InOwnedTags)
+{
+	check(IsInGameThread());
+
+	FVetInteractionTagMask OwnedMask;
+
+	const TMap<FGameplayTag, int32>& TagBits = VetInteractionTagMask::GetTagBits();
+	if (TagBits.IsEmpty() || InOwnedTags.IsEmpty())
+	{
+		return OwnedMask;
+	}
+
+	for (const FGameplayTag& Tag : InOwnedTags.GetGameplayTagParents())
+	{
+		if (const int32* const BitIndex = TagBits.Find(Tag))
+		{
+			OwnedMask.SetBit(*BitIndex);
+		}
+	}
+	return OwnedMask;
+}
+
+bool FVetInteractionTagMask::MakeFilterMask(const FGameplayTagContainer& InFilterTags, FVetInteractionTagMask& OutMask)
+{
+	check(IsInGameThread());
+
+	TMap<FGameplayTag, int32>& TagBits = VetInteractionTagMask::GetTagBits();
+
+	OutMask = FVetInteractionTagMask();
+	for (const FGameplayTag& Tag : InFilterTags)
+	{
+		int32 BitIndex = INDEX_NONE;
+		if (const int32* const FoundBitIndex = TagBits.Find(Tag))
+		{
+			BitIndex = *FoundBitIndex;
+		}
+		else if (TagBits.Num() < MaxTags)
+		{
+			BitIndex = TagBits.Add(Tag, TagBits.Num());
+		}
+		else
+		{
+			return false;
+		}
+		OutMask.SetBit(BitIndex);
+	}
+	return true;
+}
+
+uint32 FVetInteractionTagMask::GetRegistryVersion()
+{
+	return VetInteractionTagMask::GetTagBits().Num();
+}
+
+void FVetInteractionTagFilter::Compile(const FGameplayTagContainer& InRequiredTags, const FGameplayTagContainer& InBlockedTags)
+{
+	RequiredTags = InRequiredTags;
+	BlockedTags = InBlockedTags;
+
+	bUsesMasks = FVetInteractionTagMask::MakeFilterMask(RequiredTags, RequiredMask)
+		&& FVetInteractionTagMask::MakeFilterMask(BlockedTags, BlockedMask);
+}
+
+bool FVetInteractionTagFilter::Passes(const UVetInteractionComponent& InInteractor) const
+{
+	if (IsEmpty())
+	{
+		return true;
+	}
+
+	bool bPasses = false;
+	if (bUsesMasks)
+	{
+		const FVetInteractionTagMask& OwnedMask = InInteractor.GetOwnedTagMask();
+		bPasses = OwnedMask.HasAll(RequiredMask) && !OwnedMask.HasAny(BlockedMask);
+	}
+	else
+	{
+		FGameplayTagContainer OwnedTags;
+		InInteractor.GetOwnedGameplayTags(OwnedTags);
+		bPasses = OwnedTags.HasAll(RequiredTags) && !OwnedTags.HasAny(BlockedTags);
+	}
+
+	if (!bPasses)
+	{
+		INC_DWORD_STAT(STAT_VetInteraction_TagFilterRejections);
+	}
+	return bPasses;
+}
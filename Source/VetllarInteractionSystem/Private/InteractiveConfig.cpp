@@ -15,6 +15,84 @@ bool UVetInteractivePrerequisiteScript::CanBeInteractedWith(const UVetInteractio
 	return K2_CanBeInteractedWith(&InInteractor);
 }
 
+void UVetInteractivePrerequisiteScript::InvalidateCachedResults()
+{
+	CachedResults.Reset();
+}
+
+bool UVetInteractivePrerequisiteScript::CanBeFocusedOn_Internal(const UVetInteractionComponent& InInteractor) const
+{
+	if (!bCacheResults)
+	{
+		return CanBeFocusedOn(InInteractor);
+	}
+
+	FCachedResult& CachedResult = FindOrAddCachedResult(InInteractor);
+	if (!CachedResult.bCanBeFocusedOn.IsSet())
+	{
+		CachedResult.bCanBeFocusedOn = CanBeFocusedOn(InInteractor);
+	}
+	return CachedResult.bCanBeFocusedOn.GetValue();
+}
+
+bool UVetInteractivePrerequisiteScript::CanBeInteractedWith_Internal(const UVetInteractionComponent& InInteractor) const
+{
+	if (!bCacheResults)
+	{
+		return CanBeInteractedWith(InInteractor);
+	}
+
+	FCachedResult& CachedResult = FindOrAddCachedResult(InInteractor);
+	if (!CachedResult.bCanBeInteractedWith.IsSet())
+	{
+		CachedResult.bCanBeInteractedWith = CanBeInteractedWith(InInteractor);
+	}
+	return CachedResult.bCanBeInteractedWith.GetValue();
+}
+
+UVetInteractivePrerequisiteScript::FCachedResult& UVetInteractivePrerequisiteScript::FindOrAddCachedResult(const UVetInteractionComponent& InInteractor) const
+{
+	const EVetPrerequisiteDependencies DeclaredDependencies = static_cast<EVetPrerequisiteDependencies>(Dependencies);
+
+	const UVetInteractionComponent* const InteractorKey = EnumHasAnyFlags(DeclaredDependencies, EVetPrerequisiteDependencies::Interactor) ? &InInteractor : nullptr;
+
+	uint32 DependenciesHash = 0;
+	if (EnumHasAnyFlags(DeclaredDependencies, EVetPrerequisiteDependencies::InteractorTags))
+	{
+		DependenciesHash = HashCombine(DependenciesHash, InInteractor.GetOwnedGameplayTagsHash());
+	}
+	if (EnumHasAnyFlags(DeclaredDependencies, EVetPrerequisiteDependencies::Interactability))
+	{
+		const UVetInteractiveComponent* const InteractiveComponent = GetInteractiveComponent();
+		DependenciesHash = HashCombine(DependenciesHash, InteractiveComponent ? InteractiveComponent->GetInteractabilityVersion() : 0);
+	}
+
+	++UseStamp;
+
+	FCachedResult* LeastRecentlyUsed = nullptr;
+	for (FCachedResult& CachedResult : CachedResults)
+	{
+		if (CachedResult.Interactor == InteractorKey
+			&& CachedResult.DependenciesHash == DependenciesHash)
+		{
+			CachedResult.LastUseStamp = UseStamp;
+			return CachedResult;
+		}
+
+		if (LeastRecentlyUsed == nullptr || CachedResult.LastUseStamp < LeastRecentlyUsed->LastUseStamp)
+		{
+			LeastRecentlyUsed = &CachedResult;
+		}
+	}
+
+	FCachedResult& NewCachedResult = (CachedResults.Num() >= FMath::Max(MaxCachedResults, 1) && LeastRecentlyUsed) ? *LeastRecentlyUsed : CachedResults.AddDefaulted_GetRef();
+	NewCachedResult = FCachedResult();
+	NewCachedResult.Interactor = InteractorKey;
+	NewCachedResult.DependenciesHash = DependenciesHash;
+	NewCachedResult.LastUseStamp = UseStamp;
+	return NewCachedResult;
+}
+
 UVetInteractiveConfig* UVetInteractivePrerequisiteScript::GetInteractiveConfig() const
 {
 	return GetInteractiveComponent()->GetInteractiveConfig();
@@ -24,3 +102,62 @@ UVetInteractiveComponent* UVetInteractivePrerequisiteScript::GetInteractiveCompo
 {
 	return GetTypedOuter<UVetInteractiveComponent>();
 }
+
+const FVetConditionProgram& UVetInteractiveConfig::GetFocusProgram() const
+{
+	CompileConditions();
+	return FocusProgram;
+}
+
+const FVetConditionProgram& UVetInteractiveConfig::GetInteractionProgram() const
+{
+	CompileConditions();
+	return InteractionProgram;
+}
+
+const FVetInteractionTagFilter& UVetInteractiveConfig::GetTagFilter() const
+{
+	CompileConditions();
+	return TagFilter;
+}
+
+void UVetInteractiveConfig::PostLoad()
+{
+	Super::PostLoad();
+
+	CompileConditions();
+}
+
+void UVetInteractiveConfig::CompileConditions() const
+{
+	if (bConditionsCompiled)
+	{
+		return;
+	}
+
+	bConditionsCompiled = true;
+
+	FocusProgram.Reset();
+	if (FocusConditions.ContainsByPredicate([](const UVetInteractionCondition* Condition) { return IsValid(Condition); }))
+	{
+		FocusProgram.CompileList(FocusConditions, FVetConditionOp::EType::And);
+	}
+
+	InteractionProgram.Reset();
+	if (InteractionConditions.ContainsByPredicate([](const UVetInteractionCondition* Condition) { return IsValid(Condition); }))
+	{
+		InteractionProgram.CompileList(InteractionConditions, FVetConditionOp::EType::And);
+	}
+
+	TagFilter.Compile(RequiredTags, BlockedTags);
+}
+
+#if WITH_EDITOR
+void UVetInteractiveConfig::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	++Version;
+	bConditionsCompiled = false;
+}
+#endif //WITH_EDITOR
@@ -0,0 +1,71 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+
+#include "InteractiveHandle.h"
+
+//Engine
+#include "Components/PrimitiveComponent.h"
+#include "UObject/CoreNet.h"
+
+bool FVetInteractiveHandle::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	//A single bit for valid handles, 41 bits plus the packed instance index otherwise.
+	//Handles without a slot send one more bit and the object reference if there is one.
+	uint8 bValid = IsValid() ? 1 : 0;
+	Ar.SerializeBits(&bValid, 1);
+
+	uint8 bHasPrimitive = (!bValid && Map != nullptr && Primitive.IsValid()) ? 1 : 0;
+	if (!bValid)
+	{
+		Ar.SerializeBits(&bHasPrimitive, 1);
+	}
+
+	if (bValid)
+	{
+		Ar << Index;
+		Ar << Generation;
+		Ar << PrimitiveIndex;
+
+		if (Ar.IsLoading())
+		{
+			Primitive.Reset();
+		}
+	}
+	else if (bHasPrimitive)
+	{
+		UObject* PrimitiveObject = Primitive.Get();
+		Map->SerializeObject(Ar, UPrimitiveComponent::StaticClass(), PrimitiveObject);
+
+		if (Ar.IsLoading())
+		{
+			*this = FVetInteractiveHandle(Cast<UPrimitiveComponent>(PrimitiveObject));
+		}
+	}
+	else
+	{
+		if (Ar.IsLoading())
+		{
+			*this = FVetInteractiveHandle();
+		}
+
+		bOutSuccess = true;
+		return true;
+	}
+
+	uint8 bHasInstance = InstanceIndex != INDEX_NONE ? 1 : 0;
+	Ar.SerializeBits(&bHasInstance, 1);
+
+	uint32 PackedInstanceIndex = bHasInstance ? static_cast<uint32>(InstanceIndex) : 0;
+	if (bHasInstance)
+	{
+		Ar.SerializeIntPacked(PackedInstanceIndex);
+	}
+
+	if (Ar.IsLoading())
+	{
+		InstanceIndex = bHasInstance ? static_cast<int32>(PackedInstanceIndex) : INDEX_NONE;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
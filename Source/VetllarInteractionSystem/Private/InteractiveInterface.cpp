@@ -4,10 +4,125 @@
 #include "InteractiveInterface.h"
 #include "Components/InteractionComponent.h"
 #include "Components/InteractiveComponent.h"
+#include "InteractionSubsystem.h"
+#include "UObject/Script.h"
+#include "UObject/UnrealType.h"
 
 DEFINE_LOG_CATEGORY(LogVetInteractiveInterface);
 
-void IVetInteractiveInterface::BeginFocusedOn_Internal(UVetInteractionComponent& InInteractor, AActor* InInteractive, UPrimitiveComponent* InFocusedOnCompoenent)
+namespace VetInteractiveInterface
+{
+	//Cached per class information about how the interface is implemented.
+	struct FClassInfo
+	{
+		bool bImplementsInterface{false};
+
+		//Blueprint events that are actually implemented by the class, see IsResultImplementedInScript for the ones returning a value.
+		bool bImplementsK2_OnBeginFocusedOn{false};
+		bool bImplementsK2_OnEndFocusedOn{false};
+		bool bImplementsK2_GetDesiredInteractabilityState{false};
+		bool bImplementsK2_CanBeInteractedWith{false};
+		bool bImplementsK2_CanBeFocusedOn{false};
+		bool bImplementsK2_GetInteractiveComponent{false};
+	};
+
+	//Blueprints get a default implementation of every interface function with a return value, which leaves bOutFunctionImplemented false
+	//and so has its result ignored. Functions whose script never sets it to anything but false are treated as not implemented.
+	//Any other use of the parameter counts as implemented, including a pointer match by chance.
+	bool IsResultImplementedInScript(const UClass* InClass, const FName& InFunctionName)
+	{
+		if (!InClass->IsFunctionImplementedInScript(InFunctionName))
+		{
+			return false;
+		}
+
+		const UFunction* const Function = InClass->FindFunctionByName(InFunctionName);
+		const FProperty* const ImplementedProperty = Function ? FindFProperty<FProperty>(Function, TEXT("bOutFunctionImplemented")) : nullptr;
+		if (ImplementedProperty == nullptr)
+		{
+			return true;
+		}
+
+		//Loaded script code references properties by pointer
+		const ScriptPointerType PropertyPointer = reinterpret_cast<ScriptPointerType>(ImplementedProperty);
+		constexpr int32 PointerSize = sizeof(ScriptPointerType);
+		const TArray<uint8>& Script = Function->Script;
+
+		const auto& IsPropertyAt([&](int32 InOffset)
+			{
+				return InOffset >= 0 && InOffset + PointerSize <= Script.Num() && FMemory::Memcmp(&Script[InOffset], &PropertyPointer, PointerSize) == 0;
+			});
+		const auto& IsTokenAt([&](int32 InOffset, EExprToken InToken)
+			{
+				return Script.IsValidIndex(InOffset) && Script[InOffset] == InToken;
+			});
+
+		for (int32 Offset = 0; Offset + PointerSize <= Script.Num(); ++Offset)
+		{
+			if (!IsPropertyAt(Offset))
+			{
+				continue;
+			}
+
+			//LetBool LocalOutVariable <Property> False
+			if (IsTokenAt(Offset - 2, EX_LetBool) && IsTokenAt(Offset - 1, EX_LocalOutVariable) && IsTokenAt(Offset + PointerSize, EX_False))
+			{
+				Offset += PointerSize;
+				continue;
+			}
+
+			//Let <Property> LocalOutVariable <Property> False
+			if (IsTokenAt(Offset - 1, EX_Let) && IsTokenAt(Offset + PointerSize, EX_LocalOutVariable)
+				&& IsPropertyAt(Offset + PointerSize + 1) && IsTokenAt(Offset + (PointerSize * 2) + 1, EX_False))
+			{
+				Offset += (PointerSize * 2) + 1;
+				continue;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	//Only accessed from the game thread, emptied when classes can change (see ResetClassInfos).
+	TMap<TObjectKey<UClass>, FClassInfo> ClassInfos;
+
+	//Built the first time a class is seen and reused until the next reset.
+	const FClassInfo& GetClassInfo(const UClass* InClass)
+	{
+		check(IsInGameThread());
+
+		if (const FClassInfo* const ClassInfo = ClassInfos.Find(InClass))
+		{
+			return *ClassInfo;
+		}
+
+		FClassInfo& NewClassInfo = ClassInfos.Add(InClass);
+		NewClassInfo.bImplementsInterface = InClass->ImplementsInterface(UVetInteractiveInterface::StaticClass());
+		if (NewClassInfo.bImplementsInterface)
+		{
+			NewClassInfo.bImplementsK2_OnBeginFocusedOn = InClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(IVetInteractiveInterface, K2_OnBeginFocusedOn));
+			NewClassInfo.bImplementsK2_OnEndFocusedOn = InClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(IVetInteractiveInterface, K2_OnEndFocusedOn));
+			NewClassInfo.bImplementsK2_GetDesiredInteractabilityState = IsResultImplementedInScript(InClass, GET_FUNCTION_NAME_CHECKED(IVetInteractiveInterface, K2_GetDesiredInteractabilityState));
+			NewClassInfo.bImplementsK2_CanBeInteractedWith = IsResultImplementedInScript(InClass, GET_FUNCTION_NAME_CHECKED(IVetInteractiveInterface, K2_CanBeInteractedWith));
+			NewClassInfo.bImplementsK2_CanBeFocusedOn = IsResultImplementedInScript(InClass, GET_FUNCTION_NAME_CHECKED(IVetInteractiveInterface, K2_CanBeFocusedOn));
+			NewClassInfo.bImplementsK2_GetInteractiveComponent = InClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(IVetInteractiveInterface, K2_GetInteractiveComponent));
+		}
+		return NewClassInfo;
+	}
+}
+
+void IVetInteractiveInterface::ResetClassInfos()
+{
+	check(IsInGameThread());
+	VetInteractiveInterface::ClassInfos.Empty();
+}
+
+bool IVetInteractiveInterface::ImplementsInterface_Internal(const AActor* InActor)
+{
+	return IsValid(InActor) && VetInteractiveInterface::GetClassInfo(InActor->GetClass()).bImplementsInterface;
+}
+
+void IVetInteractiveInterface::BeginFocusedOn_Internal(UVetInteractionComponent& InInteractor, AActor* InInteractive, UPrimitiveComponent* InFocusedOnCompoenent, int32 InFocusedOnInstanceIndex)
 {
 	if (!IsValid(InInteractive))
 	{
@@ -16,17 +131,21 @@ void IVetInteractiveInterface::BeginFocusedOn_Internal(UVetInteractionComponent&
 
 	if (UVetInteractiveComponent* const InteractiveComponent = GetInteractiveComponent_Internal(InInteractive))
 	{
-		InteractiveComponent->BeginFocusedOn(InInteractor, InFocusedOnCompoenent);
+		InteractiveComponent->BeginFocusedOn(InInteractor, InFocusedOnCompoenent, InFocusedOnInstanceIndex);
 	}
 
 	if (IVetInteractiveInterface* const Interactive = Cast<IVetInteractiveInterface>(InInteractive))
 	{
-		Interactive->OnBeginFocusedOn(InInteractor, InFocusedOnCompoenent);
+		Interactive->OnBeginFocusedOn(InInteractor, InFocusedOnCompoenent, InFocusedOnInstanceIndex);
+	}
+
+	if (VetInteractiveInterface::GetClassInfo(InInteractive->GetClass()).bImplementsK2_OnBeginFocusedOn)
+	{
+		IVetInteractiveInterface::Execute_K2_OnBeginFocusedOn(InInteractive, &InInteractor, InFocusedOnCompoenent, InFocusedOnInstanceIndex);
 	}
-	IVetInteractiveInterface::Execute_K2_OnBeginFocusedOn(InInteractive, &InInteractor, InFocusedOnCompoenent);
 }
 
-void IVetInteractiveInterface::EndFocusedOn_Internal(UVetInteractionComponent& InInteractor, AActor* InInteractive, UPrimitiveComponent* InFocusedOnCompoenent)
+void IVetInteractiveInterface::EndFocusedOn_Internal(UVetInteractionComponent& InInteractor, AActor* InInteractive, UPrimitiveComponent* InFocusedOnCompoenent, int32 InFocusedOnInstanceIndex)
 {
 	if (!IsValid(InInteractive))
 	{
@@ -35,14 +154,18 @@ void IVetInteractiveInterface::EndFocusedOn_Internal(UVetInteractionComponent& I
 
 	if (UVetInteractiveComponent* const InteractiveComponent = GetInteractiveComponent_Internal(InInteractive))
 	{
-		InteractiveComponent->EndFocusedOn(InInteractor, InFocusedOnCompoenent);
+		InteractiveComponent->EndFocusedOn(InInteractor, InFocusedOnCompoenent, InFocusedOnInstanceIndex);
 	}
 
 	if (IVetInteractiveInterface* const Interactive = Cast<IVetInteractiveInterface>(InInteractive))
 	{
-		Interactive->OnEndFocusedOn(InInteractor, InFocusedOnCompoenent);
+		Interactive->OnEndFocusedOn(InInteractor, InFocusedOnCompoenent, InFocusedOnInstanceIndex);
+	}
+
+	if (VetInteractiveInterface::GetClassInfo(InInteractive->GetClass()).bImplementsK2_OnEndFocusedOn)
+	{
+		IVetInteractiveInterface::Execute_K2_OnEndFocusedOn(InInteractive, &InInteractor, InFocusedOnCompoenent, InFocusedOnInstanceIndex);
 	}
-	IVetInteractiveInterface::Execute_K2_OnEndFocusedOn(InInteractive, &InInteractor, InFocusedOnCompoenent);
 }
 
 EVetInteractability IVetInteractiveInterface::GetInteractabilityState_Internal(AActor* InInteractive)
@@ -54,12 +177,26 @@ EVetInteractability IVetInteractiveInterface::GetInteractabilityState_Internal(A
 
 	if (UVetInteractiveComponent* const InteractiveComponent = GetInteractiveComponent_Internal(InInteractive))
 	{
+		//Will only be valid if the interface is implemented in C++.
+		IVetInteractiveInterface* const NativeInterface = Cast<IVetInteractiveInterface>(InInteractive);
+		const bool bImplementsK2_GetDesiredInteractabilityState = VetInteractiveInterface::GetClassInfo(InInteractive->GetClass()).bImplementsK2_GetDesiredInteractabilityState;
+
+		//Overrides can change their result at any time, they are only cached if the interactive opted in.
+		const bool bCanCache = InteractiveComponent->bCacheInteractabilityOverrides
+			|| (NativeInterface == nullptr && !bImplementsK2_GetDesiredInteractabilityState);
+
+		//Reuse the last resolved state until the interactive invalidates it.
+		EVetInteractability IntaractabilityState;
+		if (bCanCache && InteractiveComponent->GetCachedInteractabilityState(IntaractabilityState))
+		{
+			return IntaractabilityState;
+		}
+
 		//If internally we are unavailable, we don't even ask overrides about it.
-		EVetInteractability IntaractabilityState = InteractiveComponent->GetInteractabilityState();
+		IntaractabilityState = InteractiveComponent->GetInteractabilityState();
 		if (IntaractabilityState < EVetInteractability::Unavailable)
 		{
-			//Will only be valid if the interface is implemented in C++.
-			if (IVetInteractiveInterface* NativeInterface = Cast<IVetInteractiveInterface>(InInteractive))
+			if (NativeInterface != nullptr)
 			{
 				const EVetInteractability NativeInteractabilty = NativeInterface->GetInteractabilityState();
 
@@ -67,11 +204,19 @@ EVetInteractability IVetInteractiveInterface::GetInteractabilityState_Internal(A
 				IntaractabilityState = NativeInteractabilty > IntaractabilityState ? NativeInteractabilty : IntaractabilityState;
 			}
 
-			bool bBPFunctionImplemented{ false };
-			const EVetInteractability BP_Interactability = IVetInteractiveInterface::Execute_K2_GetDesiredInteractabilityState(InInteractive, bBPFunctionImplemented);
+			if (bImplementsK2_GetDesiredInteractabilityState)
+			{
+				bool bBPFunctionImplemented{ false };
+				const EVetInteractability BP_Interactability = IVetInteractiveInterface::Execute_K2_GetDesiredInteractabilityState(InInteractive, bBPFunctionImplemented);
+
+				//Pick the least interactible of the states if the blueprint function is implemented
+				IntaractabilityState = (bBPFunctionImplemented && BP_Interactability > IntaractabilityState) ? BP_Interactability : IntaractabilityState;
+			}
+		}
 
-			//Pick the least interactible of the states if the blueprint function is implemented
-			IntaractabilityState = (bBPFunctionImplemented && BP_Interactability > IntaractabilityState) ? BP_Interactability : IntaractabilityState;
+		if (bCanCache)
+		{
+			InteractiveComponent->SetCachedInteractabilityState(IntaractabilityState);
 		}
 		return IntaractabilityState;
 	}
@@ -85,13 +230,21 @@ bool IVetInteractiveInterface::CanBeInteractedWith_Internal(AActor* InInteractiv
 		return false;
 	}
 
+	UVetInteractiveComponent* const InteractiveComponent = GetInteractiveComponent_Internal(InInteractive);
+
+	//Rejects incompatible interactors before any script runs
+	if (InteractiveComponent != nullptr && !InteractiveComponent->PassesTagFilter(*InInteractor))
+	{
+		return false;
+	}
+
 	const EVetInteractability InteractabilityState = GetInteractabilityState_Internal(InInteractive);
 	if (InteractabilityState != EVetInteractability::Available)
 	{
 		return false;
 	}
 
-	if (UVetInteractiveComponent* const InteractiveComponent = GetInteractiveComponent_Internal(InInteractive))
+	if (InteractiveComponent != nullptr)
 	{
 		//Internal check
 		if (!InteractiveComponent->CanBeInteractedWith(*InInteractor))
@@ -100,12 +253,15 @@ bool IVetInteractiveInterface::CanBeInteractedWith_Internal(AActor* InInteractiv
 		}
 
 		//BP check
-		bool bBP_CallImplemented{false};
-		const bool bBP_CanBeInteractedWith = IVetInteractiveInterface::Execute_K2_CanBeInteractedWith(InInteractive, InInteractor, bBP_CallImplemented);
-
-		if (bBP_CallImplemented && !bBP_CanBeInteractedWith)
+		if (VetInteractiveInterface::GetClassInfo(InInteractive->GetClass()).bImplementsK2_CanBeInteractedWith)
 		{
-			return false;
+			bool bBP_CallImplemented{false};
+			const bool bBP_CanBeInteractedWith = IVetInteractiveInterface::Execute_K2_CanBeInteractedWith(InInteractive, InInteractor, bBP_CallImplemented);
+
+			if (bBP_CallImplemented && !bBP_CanBeInteractedWith)
+			{
+				return false;
+			}
 		}
 
 		//Native check
@@ -128,13 +284,21 @@ bool IVetInteractiveInterface::CanBeFocusedOn_Internal(AActor* InInteractive, UV
 		return false;
 	}
 
+	UVetInteractiveComponent* const InteractiveComponent = GetInteractiveComponent_Internal(InInteractive);
+
+	//Rejects incompatible interactors before any script runs
+	if (InteractiveComponent != nullptr && !InteractiveComponent->PassesTagFilter(*InInteractor))
+	{
+		return false;
+	}
+
 	const EVetInteractability InteractabilityState = GetInteractabilityState_Internal(InInteractive);
 	if (InteractabilityState == EVetInteractability::Unavailable)
 	{
 		return false;
 	}
 
-	if (UVetInteractiveComponent* const InteractiveComponent = GetInteractiveComponent_Internal(InInteractive))
+	if (InteractiveComponent != nullptr)
 	{
 		//Internal check
 		if (!InteractiveComponent->CanBeFocusedOn(*InInteractor))
@@ -143,12 +307,15 @@ bool IVetInteractiveInterface::CanBeFocusedOn_Internal(AActor* InInteractive, UV
 		}
 
 		//BP check
-		bool bBP_CallImplemented{ false };
-		const bool bBP_CanBeFocusedOn = IVetInteractiveInterface::Execute_K2_CanBeFocusedOn(InInteractive, InInteractor, bBP_CallImplemented);
-
-		if (bBP_CallImplemented && !bBP_CanBeFocusedOn)
+		if (VetInteractiveInterface::GetClassInfo(InInteractive->GetClass()).bImplementsK2_CanBeFocusedOn)
 		{
-			return false;
+			bool bBP_CallImplemented{ false };
+			const bool bBP_CanBeFocusedOn = IVetInteractiveInterface::Execute_K2_CanBeFocusedOn(InInteractive, InInteractor, bBP_CallImplemented);
+
+			if (bBP_CallImplemented && !bBP_CanBeFocusedOn)
+			{
+				return false;
+			}
 		}
 
 		//Native check
@@ -174,11 +341,24 @@ UVetInteractiveComponent* IVetInteractiveInterface::GetInteractiveComponent_Inte
 	//Try to grab the interactive component from fastest to slowest calls in case the end user forgot to implement the functions.
 	UVetInteractiveComponent* InteractiveComponent{nullptr};
 
+	//Interactive components register themselves with the interaction subsystem on begin play.
+	if (const UVetInteractionSubsystem* const InteractionSubsystem = UWorld::GetSubsystem<UVetInteractionSubsystem>(InInteractive->GetWorld()))
+	{
+		InteractiveComponent = InteractionSubsystem->FindInteractiveComponent(*InInteractive);
+		if (IsValid(InteractiveComponent))
+		{
+			return InteractiveComponent;
+		}
+	}
+
 	//Check if blueprint implemented the call
-	InteractiveComponent = IVetInteractiveInterface::Execute_K2_GetInteractiveComponent(InInteractive);
-	if (IsValid(InteractiveComponent))
+	if (VetInteractiveInterface::GetClassInfo(InInteractive->GetClass()).bImplementsK2_GetInteractiveComponent)
 	{
-		return InteractiveComponent;
+		InteractiveComponent = IVetInteractiveInterface::Execute_K2_GetInteractiveComponent(InInteractive);
+		if (IsValid(InteractiveComponent))
+		{
+			return InteractiveComponent;
+		}
 	}
 
 	//check if it is natively implemented
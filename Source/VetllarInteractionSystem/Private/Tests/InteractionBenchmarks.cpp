@@ -0,0 +1,246 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+//Engine
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Components/SphereComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/AutomationTest.h"
+#include "WorldCollision.h"
+
+//Interaction
+#include "Components/InteractiveComponent.h"
+#include "InteractionSubsystem.h"
+#include "InteractiveConfig.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+//Run headless with:
+//UnrealEditor-Cmd <Project> -ExecCmds="Automation RunTests VetllarInteractionSystem.Benchmarks; Quit" -NullRHI -Unattended
+namespace VetInteractionBenchmarks
+{
+	constexpr int32 NumInteractors = 100;
+	constexpr int32 NumInteractives = 10000;
+	constexpr int32 NumFrames = 50;
+
+	//Interactives are spread over a square this big, about one every four square meters.
+	constexpr float AreaSize = 20000.0f;
+	constexpr float InteractiveRadius = 50.0f;
+
+	//Defaults of the interaction component sphere trace
+	constexpr float InteractionDistance = 100.0f;
+	constexpr float InteractionRadius = 100.0f;
+	constexpr ECollisionChannel TraceChannel = ECC_Visibility;
+
+	struct FFocusSweep
+	{
+		FVector StartLocation{FVector::ZeroVector};
+		FVector EndLocation{FVector::ZeroVector};
+	};
+
+	//Standalone game world with the interactives registered in the spatial index, destroyed with the scope.
+	class FBenchmarkWorld
+	{
+	public:
+
+		FBenchmarkWorld()
+		{
+			const UWorld::InitializationValues InitializationValues = UWorld::InitializationValues()
+				.AllowAudioPlayback(false)
+				.CreateNavigation(false)
+				.CreateAISystem(false);
+
+			World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld =*/ false, NAME_None, nullptr, /*bAddToRoot =*/ true, ERHIFeatureLevel::Num, &InitializationValues);
+			GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+			World->InitializeActorsForPlay(FURL());
+
+			FRandomStream RandomStream(/*InSeed =*/ 1);
+			const auto& GetRandomLocation([&RandomStream]()
+				{
+					return FVector(RandomStream.FRandRange(0.0f, AreaSize), RandomStream.FRandRange(0.0f, AreaSize), 0.0f);
+				});
+
+			UVetInteractiveConfig* const InteractiveConfig = NewObject<UVetInteractiveConfig>(GetTransientPackage());
+			for (int32 Index = 0; Index < NumInteractives; ++Index)
+			{
+				AActor* const Actor = World->SpawnActor<AActor>();
+
+				//Overlapping the trace channel so multi sweeps return every interactive and not only the first blocking one
+				USphereComponent* const Sphere = NewObject<USphereComponent>(Actor);
+				Sphere->InitSphereRadius(InteractiveRadius);
+				Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+				Sphere->SetCollisionResponseToAllChannels(ECR_Overlap);
+				Sphere->SetRelativeLocation(GetRandomLocation());
+				Actor->SetRootComponent(Sphere);
+				Sphere->RegisterComponent();
+
+				UVetInteractiveComponent* const Interactive = NewObject<UVetInteractiveComponent>(Actor);
+				Interactive->SetInteractiveConfig(InteractiveConfig);
+				Interactive->RegisterComponent();
+			}
+
+			for (int32 Index = 0; Index < NumInteractors; ++Index)
+			{
+				FFocusSweep& Sweep = Sweeps.AddDefaulted_GetRef();
+				Sweep.StartLocation = GetRandomLocation();
+				Sweep.EndLocation = Sweep.StartLocation + (FRotator(0.0f, RandomStream.FRandRange(0.0f, 360.0f), 0.0f).Vector() * InteractionDistance);
+			}
+
+			//Interactives register in the spatial index when they begin play
+			World->GetWorldSettings()->NotifyBeginPlay();
+
+			//The physics scene picks up the new bodies when it ticks
+			World->Tick(LEVELTICK_All, 1.0f / 60.0f);
+			World->Tick(LEVELTICK_All, 1.0f / 60.0f);
+
+			InteractionSubsystem = World->GetSubsystem<UVetInteractionSubsystem>();
+		}
+
+		~FBenchmarkWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(/*bInformEngineOfWorld =*/ false);
+		}
+
+		UWorld* World{nullptr};
+		UVetInteractionSubsystem* InteractionSubsystem{nullptr};
+		TArray<FFocusSweep> Sweeps;
+	};
+
+	//Average time of a frame in milliseconds, after a warm up frame.
+	template<typename TFunc>
+	double MeasureFrames(TFunc&& InFrameFunc)
+	{
+		InFrameFunc();
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			InFrameFunc();
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumFrames;
+	}
+}
+
+//Focus candidates of every interactor for a frame: a physics sweep each against spatial index lookups.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVetSpatialIndexBenchmark, "VetllarInteractionSystem.Benchmarks.SpatialIndex", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVetSpatialIndexBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace VetInteractionBenchmarks;
+
+	FBenchmarkWorld BenchmarkWorld;
+	UVetInteractionSubsystem* const InteractionSubsystem = BenchmarkWorld.InteractionSubsystem;
+	if (!TestNotNull(TEXT("Interaction subsystem"), InteractionSubsystem))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Indexed primitives"), InteractionSubsystem->GetNumIndexedPrimitives(), NumInteractives);
+
+	UWorld& World = *BenchmarkWorld.World;
+	const FCollisionShape SweepShape = FCollisionShape::MakeSphere(InteractionRadius);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetInteractionBenchmarkSweep), /*bTraceComplex =*/ false);
+	TArray<FHitResult> HitResults;
+	TArray<UPrimitiveComponent*> CandidatePrimitives;
+
+	//What every sphere trace interactor ran before the spatial index
+	int32 NumPhysicsHits = 0;
+	const double PhysicsTime = MeasureFrames([&]()
+		{
+			NumPhysicsHits = 0;
+			for (const FFocusSweep& Sweep : BenchmarkWorld.Sweeps)
+			{
+				HitResults.Reset();
+				World.SweepMultiByChannel(HitResults, Sweep.StartLocation, Sweep.EndLocation, FQuat::Identity, TraceChannel, SweepShape, QueryParams);
+				NumPhysicsHits += HitResults.Num();
+			}
+		});
+
+	int32 NumCandidates = 0;
+	const double IndexTime = MeasureFrames([&]()
+		{
+			NumCandidates = 0;
+			for (const FFocusSweep& Sweep : BenchmarkWorld.Sweeps)
+			{
+				CandidatePrimitives.Reset();
+				InteractionSubsystem->QueryInteractivePrimitives(Sweep.StartLocation, Sweep.EndLocation, InteractionRadius, TraceChannel, nullptr, CandidatePrimitives);
+				NumCandidates += CandidatePrimitives.Num();
+			}
+		});
+
+	//Same as bSpatialIndexNarrowPhase, the candidates are swept against one by one
+	int32 NumNarrowPhaseHits = 0;
+	const double NarrowPhaseTime = MeasureFrames([&]()
+		{
+			NumNarrowPhaseHits = 0;
+			for (const FFocusSweep& Sweep : BenchmarkWorld.Sweeps)
+			{
+				CandidatePrimitives.Reset();
+				InteractionSubsystem->QueryInteractivePrimitives(Sweep.StartLocation, Sweep.EndLocation, InteractionRadius, TraceChannel, nullptr, CandidatePrimitives);
+				for (UPrimitiveComponent* const Primitive : CandidatePrimitives)
+				{
+					FHitResult HitResult;
+					if (Primitive->SweepComponent(HitResult, Sweep.StartLocation, Sweep.EndLocation, FQuat::Identity, SweepShape, /*bTraceComplex =*/ false))
+					{
+						++NumNarrowPhaseHits;
+					}
+				}
+			}
+		});
+
+	AddInfo(FString::Printf(TEXT("%d interactors, %d interactives, average frame over %d frames:"), NumInteractors, NumInteractives, NumFrames));
+	AddInfo(FString::Printf(TEXT("Physics sweeps: %.3f ms, %d hits"), PhysicsTime, NumPhysicsHits));
+	AddInfo(FString::Printf(TEXT("Spatial index: %.3f ms, %d candidates"), IndexTime, NumCandidates));
+	AddInfo(FString::Printf(TEXT("Spatial index with narrow phase: %.3f ms, %d hits"), NarrowPhaseTime, NumNarrowPhaseHits));
+	return true;
+}
+
+//The parallel stage of the tick manager batches, each sweep snapshot run on one of N workers.
+//Worker counts above the cores of the machine can't scale, run it on machines with 4, 8 and 16 cores to compare.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVetParallelFocusSweepsBenchmark, "VetllarInteractionSystem.Benchmarks.ParallelFocusSweeps", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVetParallelFocusSweepsBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace VetInteractionBenchmarks;
+
+	FBenchmarkWorld BenchmarkWorld;
+	const UWorld& World = *BenchmarkWorld.World;
+	const TArray<FFocusSweep>& Sweeps = BenchmarkWorld.Sweeps;
+	const FCollisionShape SweepShape = FCollisionShape::MakeSphere(InteractionRadius);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VetInteractionBenchmarkBatchedSweep), /*bTraceComplex =*/ false);
+
+	//Reused like the batched queries of the subsystem so the hit arrays keep their allocations
+	TArray<TArray<FHitResult>> HitResults;
+	HitResults.SetNum(Sweeps.Num());
+
+	AddInfo(FString::Printf(TEXT("%d interactors, %d interactives, %d logical cores, %d task graph workers, average frame over %d frames:"),
+		NumInteractors, NumInteractives, FPlatformMisc::NumberOfCoresIncludingHyperthreads(), FTaskGraphInterface::Get().GetNumWorkerThreads(), NumFrames));
+
+	double SingleWorkerTime = 0.0;
+	for (const int32 NumWorkers : { 1, 4, 8, 16 })
+	{
+		const double Time = MeasureFrames([&]()
+			{
+				ParallelFor(NumWorkers, [&](int32 InWorkerIndex)
+					{
+						for (int32 SweepIndex = InWorkerIndex; SweepIndex < Sweeps.Num(); SweepIndex += NumWorkers)
+						{
+							const FFocusSweep& Sweep = Sweeps[SweepIndex];
+							HitResults[SweepIndex].Reset();
+							World.SweepMultiByChannel(HitResults[SweepIndex], Sweep.StartLocation, Sweep.EndLocation, FQuat::Identity, TraceChannel, SweepShape, QueryParams);
+						}
+					}, NumWorkers == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+			});
+
+		if (NumWorkers == 1)
+		{
+			SingleWorkerTime = Time;
+		}
+		AddInfo(FString::Printf(TEXT("%d workers: %.3f ms, %.2fx"), NumWorkers, Time, Time > 0.0 ? SingleWorkerTime / Time : 0.0));
+	}
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
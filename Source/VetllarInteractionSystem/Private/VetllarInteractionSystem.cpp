@@ -2,17 +2,51 @@
 
 #include "VetllarInteractionSystem.h"
 
+//Engine
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+//Interaction
+#include "InteractiveInterface.h"
+
 #define LOCTEXT_NAMESPACE "FVetllarInteractionSystemModule"
 
 void FVetllarInteractionSystemModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	//The interactive interface caches per class information that goes stale when classes change
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld* InWorld, bool /*bSessionEnded*/, bool /*bCleanupResources*/)
+		{
+			if (InWorld != nullptr && InWorld->IsPlayInEditor())
+			{
+				IVetInteractiveInterface::ResetClassInfos();
+			}
+		});
+
+#if WITH_EDITOR
+	ObjectsReinstancedHandle = FCoreUObjectDelegates::OnObjectsReinstanced.AddLambda([](const TMap<UObject*, UObject*>& /*InReplacedObjects*/)
+		{
+			IVetInteractiveInterface::ResetClassInfos();
+		});
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason /*InReason*/)
+		{
+			IVetInteractiveInterface::ResetClassInfos();
+		});
+#endif //WITH_EDITOR
 }
 
 void FVetllarInteractionSystemModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectsReinstanced.Remove(ObjectsReinstancedHandle);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+#endif //WITH_EDITOR
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -5,12 +5,21 @@
 //Engine
 #include "Components/ActorComponent.h"
 #include "Components/PrimitiveComponent.h"
+#include "GameplayTagContainer.h"
+#include "WorldCollision.h"
 
 //Interaction
+#include "InteractionTagMask.h"
+#include "InteractiveHandle.h"
 #include "InteractiveTypes.h"
 #include "InteractionComponent.generated.h"
 
+class UCameraComponent;
+class UInstancedStaticMeshComponent;
+class USphereComponent;
+class UVetFocusDetector;
 struct FHitResult;
+struct FVetFocusQuery;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogInteraction, Log, All);
 
@@ -23,7 +32,8 @@ UENUM(BlueprintType)
 enum class EVetInteractionTraceType : uint8
 {
 	SphereTrace_FromOwner,	//A multi sphere trace from the owning actor and forward (runs on server and client).
-	LineTrace_FromCursor	//A single line trace from the local player cursor location (runs on client).
+	LineTrace_FromCursor,	//A single line trace from the local player cursor location (runs on client).
+	Proximity_Overlap		//An overlap sphere around the owning actor, focus only updates while interactives are inside it (runs on server).
 };
 
 USTRUCT()
@@ -46,26 +56,35 @@ struct VETLLARINTERACTIONSYSTEM_API FVetInteractionComponentState
 
 	EVetInteractionResult GetResult() const { return Result; }
 
-	FORCEINLINE void SetFocusedComponent(UPrimitiveComponent* InComponent)
+	//The component focused on when the interaction started, only its handle is replicated.
+	FORCEINLINE void SetInteractingComponent(UPrimitiveComponent* InComponent, const FVetInteractiveHandle& InHandle)
 	{
-		if (InComponent != FocusedComponent)
-		{
-			FocusedComponent = InComponent;
-		}
+		InteractingComponent = InComponent;
+		InteractingHandle = InHandle;
 	}
 
-	UPrimitiveComponent* GetFocusedComponent() const {	return FocusedComponent; }
+	UPrimitiveComponent* GetInteractingComponent() const { return InteractingComponent.Get(); }
+	const FVetInteractiveHandle& GetInteractingHandle() const { return InteractingHandle; }
 
-	AActor* GetFocusedActor() const
+	//Called on clients once the handle is received.
+	void SetResolvedInteractingComponent(UPrimitiveComponent* InComponent) { InteractingComponent = InComponent; }
+
+	AActor* GetInteractingActor() const
 	{
-		if (IsValid(FocusedComponent))
+		if (const UPrimitiveComponent* const Component = InteractingComponent.Get())
 		{
-			return FocusedComponent->GetOwner();
+			return Component->GetOwner();
 		}
 		return nullptr;
 	}
 
-	uint64 GetReplicationKey() const { return ReplicationKey; }
+	uint8 GetReplicationKey() const { return ReplicationKey; }
+
+	//Key sent by the client that predicted the current interaction, 0 if it was not predicted.
+	void SetPredictionKey(uint8 InPredictionKey) { PredictionKey = InPredictionKey; }
+	uint8 GetPredictionKey() const { return PredictionKey; }
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
 
 private:
 
@@ -75,12 +94,28 @@ private:
 	UPROPERTY()
 	EVetInteractionResult Result{EVetInteractionResult::Success};
 
+	//Unlike the focused component this only changes when an interaction starts, so it is cheap to send to everyone.
 	UPROPERTY()
-	TObjectPtr<UPrimitiveComponent> FocusedComponent;
+	FVetInteractiveHandle InteractingHandle;
+
+	TWeakObjectPtr<UPrimitiveComponent> InteractingComponent;
 
-	//Used to broadcast changes to the client even if they happened in the same frame on the server
 	UPROPERTY()
-	uint64 ReplicationKey{0};
+	uint8 PredictionKey{0};
+
+	//Used to broadcast changes to the client even if they happened in the same frame on the server.
+	//Wraps around, only needs to differ from the last value received by the client.
+	UPROPERTY()
+	uint8 ReplicationKey{0};
+};
+
+template<>
+struct TStructOpsTypeTraits<FVetInteractionComponentState> : public TStructOpsTypeTraitsBase2<FVetInteractionComponentState>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
 };
 
 
@@ -105,17 +140,50 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void StopInteraction();
 
+	//The focus is only known by the server and the owning client unless bReplicateFocusToEveryone is set.
 	UFUNCTION(BlueprintCallable)
-	AActor* GetFocusedActor() const { return InteractionState.GetFocusedActor(); }
+	AActor* GetFocusedActor() const { return IsValid(FocusedComponent) ? FocusedComponent->GetOwner() : nullptr; }
 
 	UFUNCTION(BlueprintCallable)
-	UPrimitiveComponent* GetFocusedComponent() const { return InteractionState.GetFocusedComponent(); }
+	UPrimitiveComponent* GetFocusedComponent() const { return FocusedComponent; }
+
+	//Instance of the focused component if it is an instanced static mesh of a per instance interactive, INDEX_NONE otherwise.
+	UFUNCTION(BlueprintCallable)
+	int32 GetFocusedInstanceIndex() const { return FocusedInstanceIndex; }
 
 	//Returns true if this interaction component is controlled locally.
 	//Useful for situations in which we want to do something only on the client or non dedicated servers.
 	UFUNCTION(BlueprintCallable)
 	bool IsLocallyControlled() const;
 
+	//Gathers the gameplay tags owned by this interactor, including the tags of the owner if it implements IGameplayTagAssetInterface.
+	void GetOwnedGameplayTags(FGameplayTagContainer& OutOwnedTags) const;
+
+	//Mask of the owned tags used by interactive tag filters. Rebuilt at most once per frame.
+	const FVetInteractionTagMask& GetOwnedTagMask() const;
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
+	void AddOwnedTag(FGameplayTag InTag);
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
+	void RemoveOwnedTag(FGameplayTag InTag);
+
+	//Hash of the gameplay tags owned by this interactor, changes when the tags change but not when their order does.
+	uint32 GetOwnedGameplayTagsHash() const;
+
+	ECollisionChannel GetTraceChannel() const { return TraceChannel; }
+
+	//Location and direction focus candidates are scored from, the camera of the owner if it has one.
+	void GetViewPoint(FVector& OutLocation, FVector& OutDirection) const;
+
+	//Number of focus traces executed since begin play.
+	UFUNCTION(BlueprintCallable)
+	int32 GetExecutedTraceCount() const { return ExecutedTraceCount; }
+
+	//Number of focus traces skipped by the adaptive update rate since begin play.
+	UFUNCTION(BlueprintCallable)
+	int32 GetSkippedTraceCount() const { return SkippedTraceCount; }
+
 	//Default initializers
 
 	void SetDefaultTraceChannel(ECollisionChannel InTraceChannel);
@@ -141,47 +209,266 @@ protected:
 	UPROPERTY(EditDefaultsOnly)
 	TEnumAsByte<ECollisionChannel> TraceChannel{ECC_Visibility};
 
-	//The type of trace to run in order to find potential interactive objects.
+	//The type of trace to run in order to find potential interactive objects. Ignored if a focus detector is set.
 	UPROPERTY(EditDefaultsOnly)
 	EVetInteractionTraceType TraceType{EVetInteractionTraceType::SphereTrace_FromOwner};
 
+	//How much the angle to the view direction matters when picking what to focus on.
+	//A candidate to the side counts as (1 + weight) times farther away, one behind the view as (1 + 2 * weight) times.
+	//Zero picks the closest candidate regardless of the angle.
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0"))
+	float FocusAngleWeight{0.0f};
+
+	//Replaces the trace type with a custom strategy to find and score focus candidates.
+	//The detector scoring replaces the angle weight and focus priorities.
+	UPROPERTY(EditDefaultsOnly, Instanced)
+	TObjectPtr<UVetFocusDetector> FocusDetector;
+
 	//The distance of the trace to find potential interactive objects.
 	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner", EditConditionHides))
 	float InteractionDistance{ 100.f };
 
-	//The radius of the sphere that will be swept during the trace.
-	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner", EditConditionHides))
+	//The radius of the sphere that will be swept during the trace, or of the overlap sphere when using proximity.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType != EVetInteractionTraceType::LineTrace_FromCursor", EditConditionHides))
 	float InteractionRadius{ 100.f };
 
+	//The owner needs to move more than this for focus to be updated while the interactives around it stay the same.
+	//Interactive primitives need to generate overlap events to be found.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::Proximity_Overlap", EditConditionHides, Units = "cm"))
+	float ProximityLocationThreshold{10.0f};
+
+	//Object type of the proximity volume, interactive primitives must overlap or block it.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::Proximity_Overlap", EditConditionHides))
+	TEnumAsByte<ECollisionChannel> ProximityObjectType{ECC_WorldDynamic};
+
+	//Find interactives through the spatial index of the interaction subsystem instead of running a physics sweep.
+	//Geometry blocking the line of sight is not taken into account when using the index.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner", EditConditionHides))
+	bool bUseSpatialIndex{false};
+
+	//Sweeps the interaction sphere against the collision of each candidate found in the spatial index.
+	//If false only the bounds of the candidates are checked.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner && bUseSpatialIndex", EditConditionHides))
+	bool bSpatialIndexNarrowPhase{true};
+
+	//Skips focus traces while the owner stands still and no nearby interactive changed,
+	//and updates focus more often while the owner moves quickly.
+	//Cursor traces are skipped while the cursor and the camera don't move and no interactive changed under the cursor.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType != EVetInteractionTraceType::Proximity_Overlap", EditConditionHides))
+	bool bAdaptiveUpdateRate{false};
+
+	//The owner needs to move more than this since the last trace for a new trace to run.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner && bAdaptiveUpdateRate", EditConditionHides, Units = "cm"))
+	float AdaptiveLocationThreshold{5.0f};
+
+	//The owner needs to rotate more than this since the last trace for a new trace to run.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner && bAdaptiveUpdateRate", EditConditionHides, Units = "deg"))
+	float AdaptiveRotationThreshold{2.0f};
+
+	//A trace runs at least this often even if nothing seems to have changed.
+	//Catches changes the system can't track (e.g: blueprint interactability overrides).
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "bAdaptiveUpdateRate || TraceType == EVetInteractionTraceType::Proximity_Overlap", EditConditionHides, Units = "s"))
+	float AdaptiveMaxSkipTime{1.0f};
+
+	//Speed at which the owner is considered to be moving quickly.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner && bAdaptiveUpdateRate", EditConditionHides, Units = "cm/s"))
+	float FastMovementSpeed{600.0f};
+
+	//Interval between focus updates while the owner moves quickly.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner && bAdaptiveUpdateRate", EditConditionHides, Units = "s"))
+	float FastMovementUpdateInterval{0.1f};
+
+	//The owning client searches for focus locally and tells the server what it is focusing on when an interaction starts.
+	//Focus updates have no latency and cost nothing on the server, which only validates the focus when the interaction starts.
+	//Focus events are only triggered on the owning client. Not supported with a focus detector.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "FocusDetector == nullptr && TraceType == EVetInteractionTraceType::SphereTrace_FromOwner", EditConditionHides))
+	bool bClientAuthoritativeFocus{false};
+
+	//Extra distance allowed when the server validates the focus sent by the client, accounts for latency.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner && bClientAuthoritativeFocus", EditConditionHides, ClampMin = "0.0", Units = "cm"))
+	float ClientFocusDistanceTolerance{50.0f};
+
+	//Max angle between the forward vector of the owner and the focused component for the server to accept the client focus.
+	//Components within the interaction radius of the owner are accepted at any angle.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "TraceType == EVetInteractionTraceType::SphereTrace_FromOwner && bClientAuthoritativeFocus", EditConditionHides, ClampMin = "0.0", ClampMax = "180.0", Units = "deg"))
+	float ClientFocusMaxAngle{90.0f};
+
+	//Timed interactions start right away on the owning client, without waiting for the server.
+	//The server confirms or rejects the interaction and the client rolls it back if rejected.
+	UPROPERTY(EditDefaultsOnly)
+	bool bPredictInteractions{false};
+
+	//Runs focus traces asynchronously so physics queries overlap with the rest of the frame.
+	//The query is submitted on tick and its result consumed on the next frame, so focus changes lag by one frame.
+	//Touch interactions always run a blocking trace.
+	UPROPERTY(EditDefaultsOnly)
+	bool bUseAsyncTraces{false};
+
+	//Replicates the focused component to other players too, so they get the focus events of this interactor.
+	//By default only the owning client receives it.
+	UPROPERTY(EditDefaultsOnly)
+	bool bReplicateFocusToEveryone{false};
+
+	//Tags owned by this interactor, checked against the required and blocked tags of interactives.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_OwnedTags)
+	FGameplayTagContainer OwnedTags;
+
 	UPROPERTY(EditAnywhere, AdvancedDisplay)
 	bool bShowDebugMessages{false};
 
 private:
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_StartInteraction(UPrimitiveComponent* InFocusedComponent);
+	friend class UVetInteractionSubsystem;
+	friend class UVetInteractiveComponent;
+
+	struct FFocusCandidate
+	{
+		UPrimitiveComponent* Primitive{nullptr};
+		int32 InstanceIndex{INDEX_NONE};
+		FVector Location{FVector::ZeroVector};
+		float Priority{0.0f};
+	};
+
+	//Searches for a new interactive to focus on. Called on tick or by the interaction subsystem tick manager.
+	void UpdateFocus();
+
+	//Returns true if focus needs to be searched for this update.
+	bool PrepareFocusUpdate();
+
+	//True if the focus sweep can run off the game thread as part of a batch of the tick manager.
+	bool CanBatchFocusUpdate() const;
+
+	//Starts an interaction on the server, with the focused component or the one sent by the client. Returns false if it couldn't start.
+	bool StartInteraction_Internal(UPrimitiveComponent* InComponent, int32 InInstanceIndex, uint8 InPredictionKey);
+
+	//Starts a timed interaction locally on the client. Returns the prediction key or 0 if it can't be predicted.
+	uint8 PredictInteractionStart();
+
+	//Ends a predicted interaction the server rejected.
+	void RollbackPredictedInteraction();
+
+	//True if interacting or waiting for the server to confirm a predicted interaction.
+	bool IsInteractingOrPredicting() const { return InteractionState.IsInteracting() || PendingPredictionKey != 0; }
+
+	AActor* GetInteractingActor_Internal() const;
+
+	//The interaction is stopped right after starting if the client released it before the request was sent.
+	UFUNCTION(Server, Reliable)
+	void Server_StartInteraction(FVetInteractiveHandle InFocusedHandle, uint8 InPredictionKey, bool bInStopAfterStart);
+
+	//Answers a start request that didn't start an interaction. The prediction key is 0 if the start was not predicted.
+	UFUNCTION(Client, Reliable)
+	void Client_RejectInteractionStart(uint8 InPredictionKey);
 
 	UFUNCTION(Server, Reliable)
 	void Server_StopInteraction();
 
-	void SetFocusedComponent(UPrimitiveComponent* InNewFocusedComponent);
-	void SwitchFocusedComponent(UPrimitiveComponent* InNewFocusedComponent, UPrimitiveComponent* InPreviousFocusedComponent);
+	//Client side, returns false if the same request was sent recently and is still waiting for an answer.
+	bool ShouldSendRequest(double& InOutPendingRequestTime) const;
+
+	//Called on the client once the server answered the requests sent.
+	void OnRequestsAnswered();
+
+	//Sends the start request queued during the frame, along with the stop if it was released in the same frame.
+	void SendQueuedStartRequest(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
 
-	UPrimitiveComponent* GetClosestPrimitiveFromArray(const TArray<UPrimitiveComponent*>& InPrimitivesArray);
+	//Server side rate limit of the start requests, returns false if the request must be rejected.
+	bool ConsumeRequestToken();
+
+	void SetFocusedComponent(UPrimitiveComponent* InNewFocusedComponent, int32 InNewFocusedInstanceIndex = INDEX_NONE);
+
+	//Handles are resolved through the interaction subsystem, invalid or null if there is none.
+	FVetInteractiveHandle MakeInteractiveHandle(UPrimitiveComponent* InPrimitive) const;
+	UPrimitiveComponent* ResolveInteractiveHandle(const FVetInteractiveHandle& InHandle) const;
+	void SwitchFocusedComponent(UPrimitiveComponent* InNewFocusedComponent, int32 InNewFocusedInstanceIndex, UPrimitiveComponent* InPreviousFocusedComponent, int32 InPreviousFocusedInstanceIndex);
+
+	const FFocusCandidate* GetClosestCandidate(const TArray<FFocusCandidate>& InCandidates) const;
+
+	//Picks the candidate with the lowest score. Built in detectors are passed as their final type so scoring is not virtual.
+	template<typename TDetector>
+	const FFocusCandidate* GetBestScoredCandidate(const TDetector& InDetector, const FVetFocusQuery& InQuery, const TArray<FFocusCandidate>& InCandidates) const;
+
+	//False if the focused instance can't be interacted with, true if no instance is focused.
+	bool IsFocusedInstanceAvailable() const;
 
 	//Executes when the interaction has successfully completed
 	void OnInteractionCompleted(UVetInteractiveComponent& InInteractive);
 
 	void OnInteractionEnded_Internal();
 
+	//Called on clients when an instant interaction of this interactor is received, fires both the start and end events.
+	void OnInstantInteractionReplicated(UVetInteractiveComponent& InInteractive);
+
+	//Returns false if the adaptive update rate determines nothing changed since the last trace.
+	bool ShouldTraceForInteractives();
+
+	//Returns false if the proximity candidates and the owner location did not change since the last update.
+	bool ShouldRescoreProximityCandidates();
+
+	//Returns false if the cursor and the camera did not move and no interactive changed under the cursor since the last trace.
+	bool ShouldTraceFromCursor();
+
+	//Keeps the region between the cursor and what it hit, watched by ShouldTraceFromCursor.
+	void RecordCursorTraceRegion(const FHitResult& InHitResult);
+
 	void TraceForInteractives(bool bInFromTouch = false);
+	void GetSphereTraceLocations(FVector& OutStartLocation, FVector& OutEndLocation) const;
+	void SetFocusFromHitResults(const TArray<FHitResult>& InHitResults);
+	void GetSpatialIndexHits(const FVector& InStartLocation, const FVector& InEndLocation, TArray<FHitResult>& OutHitResults) const;
+	void GetInstanceHits(UInstancedStaticMeshComponent& InInstancedMesh, const FVector& InStartLocation, const FVector& InEndLocation, TArray<FHitResult>& OutHitResults) const;
 	void GetTraceHitForLocalPlayerCursor(FHitResult& OutResult, bool bInFromTouch = false) const;
 
+	//Traces the complex collision of the hit component if its interactive asks for precise picking.
+	//The hit is cleared if the cursor is over the simple collision only.
+	void RefineCursorHit(FHitResult& InOutHitResult, const FVector& InStartLocation, const FVector& InEndLocation) const;
+	void GetProximityHits(TArray<FHitResult>& OutHitResults) const;
+
+	void CreateProximityVolume();
+	void DestroyProximityVolume();
+
+	UFUNCTION()
+	void OnProximityBeginOverlap(UPrimitiveComponent* InOverlappedComponent, AActor* InOtherActor, UPrimitiveComponent* InOtherComponent, int32 InOtherBodyIndex, bool bInFromSweep, const FHitResult& InSweepResult);
+
+	UFUNCTION()
+	void OnProximityEndOverlap(UPrimitiveComponent* InOverlappedComponent, AActor* InOtherActor, UPrimitiveComponent* InOtherComponent, int32 InOtherBodyIndex);
+
+	void SubmitAsyncTrace();
+	void OnAsyncTraceCompleted(const FTraceHandle& InTraceHandle, FTraceDatum& InTraceDatum);
+
 	void ConditionallySetTickEnabled(bool bInEnabled);
 
+	//True if focus is searched for on this machine.
+	bool UpdatesFocusLocally() const;
+
+	//True if focus is searched for by the local player and sent to the server when an interaction starts.
+	bool IsFocusFromLocalPlayer() const;
+
+	//True if the focus the client sent is close enough, in front of the owner and in sight.
+	bool ValidateClientFocus(const UPrimitiveComponent& InFocusedComponent, int32 InFocusedInstanceIndex) const;
+
 	UFUNCTION()
 	void OnRep_InteractionState(const FVetInteractionComponentState& InPreviousState);
 
+	UFUNCTION()
+	void OnRep_FocusedHandle();
+
+	UFUNCTION()
+	void OnRep_SharedFocusedHandle();
+
+	void SetFocusFromHandle(const FVetInteractiveHandle& InHandle);
+
+	//Resolves the focused and interacting handles received before their interactives, called by the interaction subsystem.
+	void ResolvePendingHandles();
+
+	//Registers with the interaction subsystem while some handle is pending.
+	void UpdateWaitingForHandles();
+
+	UFUNCTION()
+	void OnRep_OwnedTags();
+
+	//Flags the replicated state to be sent, it is only compared when marked dirty.
+	void MarkInteractionStateDirty();
+
 	//checks if the actor that owns this component is in a local player world.
 	bool IsLocal() const;
 
@@ -191,4 +478,90 @@ private:
 
 	UPROPERTY(ReplicatedUsing = OnRep_InteractionState)
 	FVetInteractionComponentState InteractionState;
+
+	//Replicated through its handle.
+	UPROPERTY(Transient)
+	TObjectPtr<UPrimitiveComponent> FocusedComponent;
+
+	int32 FocusedInstanceIndex{INDEX_NONE};
+
+	//Handle of the focused component, only replicated to the owner.
+	UPROPERTY(ReplicatedUsing = OnRep_FocusedHandle)
+	FVetInteractiveHandle FocusedHandle;
+
+	//Copy of the focused handle replicated to everyone but the owner, only set if bReplicateFocusToEveryone.
+	UPROPERTY(ReplicatedUsing = OnRep_SharedFocusedHandle)
+	FVetInteractiveHandle SharedFocusedHandle;
+
+	//True while focus is being updated, either by our own tick or by the tick manager.
+	bool bFocusUpdatesEnabled{false};
+
+	//True if focus updates are driven by the interaction subsystem instead of our own tick.
+	bool bUsesTickManager{false};
+
+	//Data captured on the last trace, the location and rotation are the ones of the camera for cursor traces
+	FVector LastTraceLocation{FVector::ZeroVector};
+	FRotator LastTraceRotation{FRotator::ZeroRotator};
+	FVector2f LastCursorPosition{FVector2f::ZeroVector};
+	uint32 LastTraceRegionVersion{0};
+	double LastTraceTime{-1.0};
+
+	//Invalid if the last cursor trace hit nothing
+	FBox LastCursorTraceRegion{ForceInit};
+
+	//Tick interval set on the component before the adaptive update rate changes it
+	float BaseTickInterval{0.25f};
+
+	int32 ExecutedTraceCount{0};
+	int32 SkippedTraceCount{0};
+
+	//Found on begin play, focus is scored from the owner if there is none.
+	TWeakObjectPtr<UCameraComponent> ViewCamera;
+
+	//Only created when using proximity, on the machine that updates focus.
+	UPROPERTY(Transient)
+	TObjectPtr<USphereComponent> ProximityVolume;
+
+	//Interactive primitives inside the proximity volume and the number of their bodies overlapping it.
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, int32> ProximityCandidates;
+
+	//Something entered or left the proximity volume since the last update.
+	bool bProximityCandidatesChanged{false};
+
+	//Async query submitted on the last trace, invalid if no query is in flight.
+	FTraceHandle PendingTraceHandle;
+	FTraceDelegate AsyncTraceDelegate;
+
+	//Last prediction key used, wraps skipping 0.
+	uint8 LastPredictionKey{0};
+
+	//Focus handle received before its interactive, see ResolvePendingHandles.
+	FVetInteractiveHandle PendingFocusHandle;
+	bool bWaitingForHandles{false};
+
+	//Key of the predicted interaction waiting for the server, 0 if none.
+	uint8 PendingPredictionKey{0};
+	TWeakObjectPtr<UPrimitiveComponent> PredictedInteractingComponent;
+
+	//Real time at which the last start and stop requests were sent, negative if answered.
+	double PendingStartRequestTime{-1.0};
+	double PendingStopRequestTime{-1.0};
+
+	//The interaction was stopped before the server answered the start request.
+	bool bStopAfterStartRequest{false};
+
+	//Start request sent once the actors are done ticking, RPCs don't leave before the end of the frame anyway.
+	//Valid while a request is queued.
+	FDelegateHandle QueuedStartRequestHandle;
+	FVetInteractiveHandle QueuedStartFocusedHandle;
+	uint8 QueuedStartPredictionKey{0};
+	bool bStopQueuedStartRequest{false};
+
+	//Token bucket of the start requests received from the client
+	float RequestTokens{0.0f};
+	double LastRequestTokenTime{-1.0};
+
+	mutable FVetInteractionTagMask OwnedTagMask;
+	mutable uint64 OwnedTagMaskFrame{MAX_uint64};
+	mutable uint32 OwnedTagMaskRegistryVersion{0};
 };
@@ -5,17 +5,21 @@
 //Engine
 #include "Components/ActorComponent.h"
 #include "Components/PrimitiveComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
 
 //Interaction
 #include "InteractiveConfig.h"
+#include "InteractiveHandle.h"
 #include "InteractiveTypes.h"
 #include "InteractiveComponent.generated.h"
 
 class UVetInteractionComponent;
+class UVetInteractiveComponent;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogVetInteractive, Log, All);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInteractabilityStateChanged, EVetInteractability, NewInteractabilityState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnInstanceInteractabilityStateChanged, int32, InstanceIndex, EVetInteractability, NewInteractabilityState);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnInteractionStarted_Multicast, UVetInteractionComponent*, InInteractor, UPrimitiveComponent*, FocusedOnComponent);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnInteractionEnded_Multicast, UVetInteractionComponent*, InInteractor, EVetInteractionResult, InteractionResult, UPrimitiveComponent*, FocusedOnComponent);
 
@@ -26,24 +30,37 @@ struct VETLLARINTERACTIONSYSTEM_API FVetInteractiveState
 {
 	GENERATED_BODY()
 
-	FORCEINLINE void SetIsBeingInteractedWith(bool bInNewIsBeingInteractedWith, UPrimitiveComponent* InFocusedOnComponent = nullptr)
+	//The primitive index is the one of the focused on component in its interactive, see UVetInteractiveComponent::GetPrimitiveIndex.
+	FORCEINLINE void SetIsBeingInteractedWith(bool bInNewIsBeingInteractedWith, UPrimitiveComponent* InFocusedOnComponent = nullptr, int32 InFocusedOnInstanceIndex = INDEX_NONE, uint8 InFocusedOnPrimitiveIndex = FVetInteractiveHandle::NoPrimitive)
 	{
 		bIsBeingInteractedWith = bInNewIsBeingInteractedWith;
 		
 		//We want to keep this valid since during an instant interaction this will not replicate
 		//correctly if nulled after broadcasting on the server.
-		if (IsValid(InFocusedOnComponent)
-			&& InFocusedOnComponent != FocuedOnComponent)
+		if (IsValid(InFocusedOnComponent))
 		{
 			FocuedOnComponent = InFocusedOnComponent;
+			FocusedOnInstanceIndex = InFocusedOnInstanceIndex;
+			FocusedOnPrimitiveIndex = InFocusedOnPrimitiveIndex;
 		}
 
 		ReplicationKey++;
 	}
 
 	bool IsBeingInteractedWith() const { return bIsBeingInteractedWith; }
-	uint64 GetReplicationKey() const { return ReplicationKey; }
+	uint8 GetReplicationKey() const { return ReplicationKey; }
+
+	//Server world time at which the current interaction started.
+	void SetInteractionStartTime(double InInteractionStartTime) { InteractionStartTime = InInteractionStartTime; }
+	double GetInteractionStartTime() const { return InteractionStartTime; }
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
 	UPrimitiveComponent* GetFocusedOnComponent() const { return FocuedOnComponent.Get(); }
+	int32 GetFocusedOnInstanceIndex() const { return FocusedOnInstanceIndex; }
+
+	//Clients only receive the primitive index of the focused on component, resolved once the interactive indexed its primitives.
+	void ResolveFocusedOnComponent(const UVetInteractiveComponent& InInteractive);
 
 	UPROPERTY()
 	EVetInteractability InteractabilityState{EVetInteractability::Available};
@@ -60,8 +77,73 @@ private:
 	UPROPERTY()
 	TWeakObjectPtr<UPrimitiveComponent> FocuedOnComponent;
 
+	//Instance of the focused on component, if interacted with per instance
 	UPROPERTY()
-	uint64 ReplicationKey{0};
+	int32 FocusedOnInstanceIndex{INDEX_NONE};
+
+	//Sent instead of the focused on component, which is only sent as an object reference if it has no index
+	UPROPERTY()
+	uint8 FocusedOnPrimitiveIndex{FVetInteractiveHandle::NoPrimitive};
+
+	UPROPERTY()
+	double InteractionStartTime{0.0};
+
+	//Wraps around, only needs to differ from the last value received by the client.
+	UPROPERTY()
+	uint8 ReplicationKey{0};
+};
+
+template<>
+struct TStructOpsTypeTraits<FVetInteractiveState> : public TStructOpsTypeTraitsBase2<FVetInteractiveState>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+//Interactability of a single instance of a per instance interactive.
+USTRUCT()
+struct VETLLARINTERACTIONSYSTEM_API FVetInstanceStateItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	void PreReplicatedRemove(const struct FVetInstanceStateArray& InArraySerializer);
+	void PostReplicatedAdd(const struct FVetInstanceStateArray& InArraySerializer);
+	void PostReplicatedChange(const struct FVetInstanceStateArray& InArraySerializer);
+
+	UPROPERTY()
+	int32 InstanceIndex{INDEX_NONE};
+
+	UPROPERTY()
+	EVetInteractability InteractabilityState{EVetInteractability::Available};
+};
+
+//Sparse list of the instances that are not available, instances not in the list are available.
+USTRUCT()
+struct VETLLARINTERACTIONSYSTEM_API FVetInstanceStateArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FVetInstanceStateItem, FVetInstanceStateArray>(Items, DeltaParms, *this);
+	}
+
+	UPROPERTY()
+	TArray<FVetInstanceStateItem> Items;
+
+	//Notified when items are received
+	UVetInteractiveComponent* Owner{nullptr};
+};
+
+template<>
+struct TStructOpsTypeTraits<FVetInstanceStateArray> : public TStructOpsTypeTraitsBase2<FVetInstanceStateArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
 };
 
 UCLASS( ClassGroup=(Interaction), meta=(BlueprintSpawnableComponent) )
@@ -74,19 +156,76 @@ public:
 
 	bool CanBeFocusedOn(UVetInteractionComponent& InInteractor) const;
 	bool CanBeInteractedWith(UVetInteractionComponent& InInteractor) const;
-	bool StartInteraction(UVetInteractionComponent& InInteractor, const FOnInteractionComplete& InCompleteDelegate, UPrimitiveComponent* InFocuedOnComponent);
+
+	//Checks the interactor tags against the required and blocked tags of the config.
+	//Cheap enough to run before any other check.
+	bool PassesTagFilter(const UVetInteractionComponent& InInteractor) const;
+	bool StartInteraction(UVetInteractionComponent& InInteractor, const FOnInteractionComplete& InCompleteDelegate, UPrimitiveComponent* InFocuedOnComponent, int32 InFocusedOnInstanceIndex = INDEX_NONE);
 	void CancelInteraction();
+
+	//Client side start of an interaction predicted by a local interactor, only triggers cosmetic events and progress.
+	void StartPredictedInteraction(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex = INDEX_NONE);
+
+	//Rolls back a predicted interaction rejected by the server.
+	void CancelPredictedInteraction();
 		
-	void BeginFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent);
-	void EndFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent);
+	//The instance index is INDEX_NONE unless this is interacted with per instance.
+	void BeginFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex);
+	void EndFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex);
 
 	EVetInteractability GetInteractabilityState() const { return InteractiveState.InteractabilityState; }
 	UVetInteractionComponent* GetCurrentInteractor() { return CurrentInteractor.Get(); }
 	UVetInteractiveConfig* GetInteractiveConfig() { return InteractiveConfig; }
+	float GetFocusPriority() const { return InteractiveConfig ? InteractiveConfig->FocusPriority : 0.0f; }
+	bool UsesPrecisePicking() const { return InteractiveConfig && InteractiveConfig->bPrecisePicking; }
 
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
 	void SetIsEnabled(bool bInNewEnabled);
 
+	//Changes the configuration of this interactive. Any interaction taking place is not affected.
+	//The config is not replicated, call this on both the server and the clients.
+	UFUNCTION(BlueprintCallable)
+	void SetInteractiveConfig(UVetInteractiveConfig* InInteractiveConfig);
+
+	//Invalidates the cached interactability of this interactive.
+	//With bCacheInteractabilityOverrides enabled, must be called whenever something the native or blueprint
+	//interactability overrides depend on changes, otherwise interactors will keep using the last result.
+	UFUNCTION(BlueprintCallable)
+	void MarkInteractabilityDirty();
+
+	//True if instances of instanced static mesh components of the owner are focused on and interacted with individually.
+	bool UsesPerInstanceInteraction() const { return bPerInstanceInteraction; }
+
+	//Interactability of an instance, never better than the interactability of the whole interactive.
+	UFUNCTION(BlueprintCallable)
+	EVetInteractability GetInstanceInteractability(int32 InInstanceIndex) const;
+
+	//Changes the interactability of a single instance, e.g: to disable a harvested resource until it grows back.
+	//Only instances that are not available are replicated.
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
+	void SetInstanceInteractability(int32 InInstanceIndex, EVetInteractability InInteractabilityState);
+
+	//Instance the current or last interaction happened with, INDEX_NONE if it was not with an instance.
+	UFUNCTION(BlueprintCallable)
+	int32 GetInteractingInstanceIndex() const { return InteractingInstanceIndex; }
+
+	//Network handle assigned by the server, invalid on clients until it replicates.
+	const FVetInteractiveHandle& GetHandle() const { return Handle; }
+
+	//False if clients never receive the handle, the interactive or its owner are not replicated.
+	bool HasReplicatedHandle() const;
+
+	//Index of a primitive of the owner, the same on the server and the clients since only primitives with stable names are indexed.
+	//Returns FVetInteractiveHandle::NoPrimitive if the primitive is not owned by the owner of this interactive or was created at runtime.
+	uint8 GetPrimitiveIndex(const UPrimitiveComponent& InPrimitive) const;
+	UPrimitiveComponent* GetPrimitiveAtIndex(uint8 InPrimitiveIndex) const;
+
+	//Changes every time the interactability of this interactive is invalidated.
+	uint32 GetInteractabilityVersion() const { return InteractabilityVersion; }
+
+	//World time at which the last interaction with this interactive ended, negative if it never ended.
+	double GetLastInteractionEndTime() const { return LastInteractionEndTime; }
+
 	//Gets the progress of the current timed interaction as a percent.
 	//Returns false if this is not a timed interactive or if no interaction is taking place.
 	//Outs a value between 0 and 1 based on the elapsed time and the required time.
@@ -99,12 +238,16 @@ public:
 	UFUNCTION(BlueprintCallable)
 	bool GetCurrentInteractionRemainingTime(float& OutRemainingTime, float& OutRequiredTime) const;
 
+	//Also true on the client while a local interaction is predicted.
 	UFUNCTION(BlueprintCallable)
-	bool IsBeingInteractedWith() const { return InteractiveState.IsBeingInteractedWith(); }
+	bool IsBeingInteractedWith() const { return InteractiveState.IsBeingInteractedWith() || PredictedInteractionStartTime >= 0.0; }
 
 	UPROPERTY(BlueprintAssignable)
 	FOnInteractabilityStateChanged OnInteractabilityStateChanged;
 
+	UPROPERTY(BlueprintAssignable)
+	FOnInstanceInteractabilityStateChanged OnInstanceInteractabilityStateChanged;
+
 	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "On Interaction Started"))
 	FOnInteractionStarted_Multicast K2_OnInteractionStarted;
 
@@ -114,16 +257,17 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Begin Focused On"))
-	void K2_OnBeginFocusedOn(UVetInteractionComponent* InInteractor, UPrimitiveComponent* InFocusedOnComponent);
+	void K2_OnBeginFocusedOn(UVetInteractionComponent* InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex);
 
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On End Focused On"))
-	void K2_OnEndFocusedOn(UVetInteractionComponent* InInteractor, UPrimitiveComponent* InFocusedOnComponent);
+	void K2_OnEndFocusedOn(UVetInteractionComponent* InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex);
 
-	virtual void OnBeginFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent) {}
-	virtual void OnEndFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent) {}
+	virtual void OnBeginFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex) {}
+	virtual void OnEndFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex) {}
 
 	//Set to true if you want this interactive to be available on start.
 	UPROPERTY(EditAnywhere)
@@ -133,32 +277,139 @@ protected:
 	UPROPERTY(EditAnywhere)
 	TObjectPtr<UVetInteractiveConfig> InteractiveConfig;
 
+	//Allows the interaction system to put the owner in net dormancy while idle, if enabled in the project settings.
+	//Disable it if the owner replicates other state that changes while nobody interacts with it.
+	UPROPERTY(EditAnywhere)
+	bool bAllowNetDormancy{true};
+
+	//Instances of instanced static mesh components of the owner are focused on and interacted with individually,
+	//so a single actor can hold thousands of interactives. Timed interactions still happen one at a time per interactive.
+	//Instance indices must be stable, disable instances through SetInstanceInteractability instead of removing them.
+	UPROPERTY(EditAnywhere)
+	bool bPerInstanceInteraction{false};
+
+	//Reuses the result of the native and blueprint interactability overrides until MarkInteractabilityDirty is called.
+	//Only enable it if the overrides are not evaluated dynamically. Owners without overrides are always cached.
+	UPROPERTY(EditAnywhere)
+	bool bCacheInteractabilityOverrides{false};
+
 private:
 
+	friend class IVetInteractiveInterface;
+	friend class UVetInteractionSubsystem;
+	friend struct FVetInstanceStateItem;
+
+	//Stores the interactability of an instance and notifies about the change, on both the server and the clients.
+	void SetInstanceInteractability_Internal(int32 InInstanceIndex, EVetInteractability InInteractabilityState);
+
+	//Returns false if the cached interactability has been invalidated since it was stored.
+	bool GetCachedInteractabilityState(EVetInteractability& OutInteractabilityState) const;
+	void SetCachedInteractabilityState(EVetInteractability InInteractabilityState);
+
+	//Flags the replicated state to be sent, it is only compared when marked dirty.
+	void MarkInteractiveStateDirty();
+
+	void CreatePrerequisiteScript();
 	void EvaluateInteractabilityState_Internal();
 
 	UFUNCTION()
 	void OnRep_InteractiveState(const FVetInteractiveState& InPreviousState);
 
+	UFUNCTION()
+	void OnRep_Handle();
+
+	//Fills IndexedPrimitives, called once on begin play.
+	void BuildPrimitiveIndices();
+
 	void OnInteractionStarted();
 	void OnInteractionEnded(EVetInteractionResult InResult);
 
 	void CompleteInteraction_Internal();
 	void EndInteraction_Internal();
 
+	//Instant interactions don't change the replicated state, they are sent to clients as a single event.
+	void ExecuteInstantInteraction(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex);
+
+	//Cosmetic only, lost events are not resent.
+	//The focused on component is sent as its primitive index.
+	UFUNCTION(NetMulticast, Unreliable)
+	void Multicast_InstantInteraction(UVetInteractionComponent* InInteractor, uint8 InFocusedOnPrimitiveIndex, int32 InFocusedOnInstanceIndex, uint8 InSequence);
+
+	//Called by the interaction subsystem timer wheel once a timed interaction reaches its deadline.
+	void OnInteractionTimerExpired();
+
+	//Time passed since the current interaction started, based on the synchronized server time.
+	float GetInteractionElapsedTime() const;
+
+	double GetServerWorldTime() const;
+
+	//Wakes the owner from net dormancy before an interaction starts replicating to clients.
+	void WakeFromNetDormancy();
+
+	//Records replicated activity and flushes the change if the owner is dormant, without waking it.
+	void NotifyNetActivity();
+
+	void ScheduleDormancyTimer(double InDeadline);
+
+	//Called by the interaction subsystem timer wheel to put the owner back in net dormancy if it stayed idle.
+	void OnDormancyTimerExpired();
+
 	UPROPERTY(ReplicatedUsing = OnRep_InteractiveState)
 	FVetInteractiveState InteractiveState;
 
+	UPROPERTY(Replicated)
+	FVetInstanceStateArray InstanceStates;
+
+	//Interactability of every instance indexed by instance, instances past the end are available.
+	TArray<EVetInteractability> InstanceInteractability;
+
+	//Server only, index of the item of each instance in the replicated instance states or INDEX_NONE.
+	TArray<int32> InstanceStateItemIndices;
+
+	int32 InteractingInstanceIndex{INDEX_NONE};
+
+	//Never changes once assigned, only sent with the initial replication of the interactive.
+	UPROPERTY(ReplicatedUsing = OnRep_Handle)
+	FVetInteractiveHandle Handle;
+
+	//Primitives of the owner with names stable for networking sorted by name, the position is the primitive index.
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UPrimitiveComponent>> IndexedPrimitives;
+
 	UPROPERTY(Transient)
 	TObjectPtr<UVetInteractivePrerequisiteScript> InteractionPrerequisiteScript;
 
 	//Valid if this is being interacted with
 	TWeakObjectPtr<UVetInteractionComponent> CurrentInteractor;
 
-	//The time that passed since the interaction started.
-	//NOT REPLICATED. This value is predicted on clients for cosmetic purposes only.
-	float InteractionElapsedTime{0.0f};
+	//Sequence of the last instant interaction event sent by the server or received by the client.
+	uint8 InstantInteractionSequence{0};
+	bool bReceivedInstantInteraction{false};
+
+	//Server world time at which the local interactor predicted the current interaction started, negative if not predicted.
+	//Kept until the interaction ends so the progress doesn't jump back when the server confirms it.
+	double PredictedInteractionStartTime{-1.0};
+
+	//Component the local interactor predicted the interaction with, the replicated one is stale until the server confirms it.
+	TWeakObjectPtr<UPrimitiveComponent> PredictedFocusedOnComponent;
+
+	//Deadline of the current timed interaction scheduled in the interaction subsystem, negative if none.
+	double ScheduledInteractionDeadline{-1.0};
+
+	//Server only, set on begin play if the interaction system handles the net dormancy of the owner.
+	bool bManagesNetDormancy{false};
+	bool bDormancyTimerScheduled{false};
+	double LastNetActivityTime{0.0};
 
 	//Used to notify the interaction component that the interaction ended
 	FOnInteractionComplete OnInteractionComplete;
+
+	uint32 InteractabilityVersion{1};
+
+	double LastInteractionEndTime{-1.0};
+
+	//Interactability resolved by IVetInteractiveInterface, including the native and blueprint overrides.
+	EVetInteractability CachedInteractabilityState{EVetInteractability::Unavailable};
+	uint32 CachedInteractabilityVersion{0};
+	uint32 CachedConfigVersion{0};
 };
@@ -0,0 +1,150 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+#pragma once
+
+//Engine
+#include "Engine/EngineTypes.h"
+#include "UObject/Object.h"
+
+//Interaction
+#include "FocusDetectors.generated.h"
+
+class UVetInteractionComponent;
+struct FHitResult;
+
+//Data available to detectors while searching for focus.
+struct VETLLARINTERACTIONSYSTEM_API FVetFocusQuery
+{
+	FVetFocusQuery(const UVetInteractionComponent& InInteractor, bool bInFromTouch);
+
+	const UVetInteractionComponent& Interactor;
+	const AActor& Owner;
+	UWorld& World;
+	ECollisionChannel TraceChannel;
+
+	//Camera of the owner if it has one, the owner otherwise.
+	FVector ViewLocation;
+	FVector ViewDirection;
+
+	bool bFromTouch;
+};
+
+//Built in detectors, called by the interaction component without virtual dispatch.
+enum class EVetFocusDetectorType : uint8
+{
+	Custom,
+	SphereSweep,
+	ViewCone,
+	Cursor,
+	Overlap
+};
+
+/**
+ * Base class for the strategies used by interaction components to find and score focus candidates.
+ * Interactives that can't be focused on are filtered out by the component, detectors only need to find them.
+ */
+UCLASS(Abstract, EditInlineNew, DefaultToInstanced, CollapseCategories)
+class VETLLARINTERACTIONSYSTEM_API UVetFocusDetector : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	//Adds the primitives that could be focused on. Per instance interactives are expected to set the hit item to the instance index.
+	virtual void GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const PURE_VIRTUAL(UVetFocusDetector::GatherCandidates, );
+
+	//The candidate with the lowest score is focused on. Defaults to the squared distance to the view location.
+	virtual float ScoreCandidate(const FVetFocusQuery& InQuery, const FVector& InCandidateLocation) const;
+
+	//Detectors that need the local player run on the owning client, the focus is sent to the server when an interaction starts.
+	virtual bool RunsOnLocalPlayer() const { return false; }
+
+	EVetFocusDetectorType GetType() const { return Type; }
+
+private:
+
+	friend class UVetFocusDetector_SphereSweep;
+	friend class UVetFocusDetector_ViewCone;
+	friend class UVetFocusDetector_Cursor;
+	friend class UVetFocusDetector_Overlap;
+
+	//Set by the built in detectors only, which are final so the component can cast to them safely.
+	EVetFocusDetectorType Type{EVetFocusDetectorType::Custom};
+};
+
+//A multi sphere sweep from the owner and forward.
+UCLASS(meta = (DisplayName = "Sphere Sweep"))
+class VETLLARINTERACTIONSYSTEM_API UVetFocusDetector_SphereSweep final : public UVetFocusDetector
+{
+	GENERATED_BODY()
+
+public:
+
+	UVetFocusDetector_SphereSweep() { Type = EVetFocusDetectorType::SphereSweep; }
+
+	virtual void GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const override;
+
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0", Units = "cm"))
+	float Distance{100.0f};
+
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0", Units = "cm"))
+	float Radius{100.0f};
+};
+
+//Interactives in front of the view, preferring the ones closer to its center.
+UCLASS(meta = (DisplayName = "View Cone"))
+class VETLLARINTERACTIONSYSTEM_API UVetFocusDetector_ViewCone final : public UVetFocusDetector
+{
+	GENERATED_BODY()
+
+public:
+
+	UVetFocusDetector_ViewCone() { Type = EVetFocusDetectorType::ViewCone; }
+
+	virtual void GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const override;
+	virtual float ScoreCandidate(const FVetFocusQuery& InQuery, const FVector& InCandidateLocation) const override;
+
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0", Units = "cm"))
+	float Range{300.0f};
+
+	//Max angle between the view direction and a candidate.
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0", ClampMax = "180.0", Units = "deg"))
+	float HalfAngle{30.0f};
+
+	//How much more being centered matters than being close.
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0"))
+	float AngleWeight{4.0f};
+};
+
+//A single line trace under the local player cursor, or finger when touching.
+UCLASS(meta = (DisplayName = "Cursor"))
+class VETLLARINTERACTIONSYSTEM_API UVetFocusDetector_Cursor final : public UVetFocusDetector
+{
+	GENERATED_BODY()
+
+public:
+
+	UVetFocusDetector_Cursor() { Type = EVetFocusDetectorType::Cursor; }
+
+	virtual void GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const override;
+	virtual bool RunsOnLocalPlayer() const override { return true; }
+
+	UPROPERTY(EditDefaultsOnly)
+	bool bTraceComplex{false};
+};
+
+//Everything overlapping a sphere around the owner.
+UCLASS(meta = (DisplayName = "Overlap"))
+class VETLLARINTERACTIONSYSTEM_API UVetFocusDetector_Overlap final : public UVetFocusDetector
+{
+	GENERATED_BODY()
+
+public:
+
+	UVetFocusDetector_Overlap() { Type = EVetFocusDetectorType::Overlap; }
+
+	virtual void GatherCandidates(const FVetFocusQuery& InQuery, TArray<FHitResult>& OutHitResults) const override;
+
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0", Units = "cm"))
+	float Radius{150.0f};
+};
@@ -0,0 +1,231 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+#pragma once
+
+//Engine
+#include "GameplayTagContainer.h"
+#include "UObject/Object.h"
+
+//Interaction
+#include "InteractionConditions.generated.h"
+
+class UVetInteractionComponent;
+class UVetInteractionCondition;
+class UVetInteractionCondition_Native;
+class UVetInteractiveComponent;
+
+//Data available to conditions during evaluation.
+struct VETLLARINTERACTIONSYSTEM_API FVetConditionContext
+{
+	FVetConditionContext(const UVetInteractionComponent& InInteractor, const UVetInteractiveComponent& InInteractive)
+		: Interactor(InInteractor)
+		, Interactive(InInteractive)
+	{}
+
+	const UVetInteractionComponent& Interactor;
+	const UVetInteractiveComponent& Interactive;
+};
+
+//A single instruction of a compiled condition program.
+struct FVetConditionOp
+{
+	enum class EType : uint8
+	{
+		HasTag,		//Pushes true if the interactor owns Tag (exact match if bFlag)
+		Distance,	//Pushes true if the interactor is closer than sqrt(Value) to the interactive
+		Facing,		//Pushes true if the cosine of the angle between the interactor forward and the interactive is greater than Value
+		Cooldown,	//Pushes true if more than Value seconds passed since the last interaction with the interactive ended
+		Team,		//Pushes true if interactor and interactive are on the same team (different teams if bFlag)
+		Native,		//Pushes the result of NativeCondition
+		And,		//Pops OperandCount values and pushes true if all of them are true
+		Or,			//Pops OperandCount values and pushes true if any of them is true
+		Not			//Pops one value and pushes its negation
+	};
+
+	EType Type{EType::And};
+	bool bFlag{false};
+	uint16 OperandCount{0};
+	float Value{0.0f};
+	FGameplayTag Tag;
+
+	//Owned by the config the program was compiled from
+	const UVetInteractionCondition_Native* NativeCondition{nullptr};
+};
+
+/**
+ * Flat postfix program compiled from a tree of conditions.
+ * Evaluated with a small stack and without going through the blueprint VM.
+ */
+struct VETLLARINTERACTIONSYSTEM_API FVetConditionProgram
+{
+	//An empty program always passes
+	bool IsEmpty() const { return Ops.IsEmpty(); }
+
+	bool Evaluate(const FVetConditionContext& InContext) const;
+
+	void Reset();
+
+	//Adds an instruction, InOperandCount is only used by And/Or.
+	FVetConditionOp& AddOp(FVetConditionOp::EType InType, uint16 InOperandCount = 0);
+
+	//Compiles a list of conditions joined by InJoinType (And/Or) that pushes a single value.
+	//Null conditions are skipped.
+	void CompileList(const TArray<TObjectPtr<UVetInteractionCondition>>& InConditions, FVetConditionOp::EType InJoinType);
+
+private:
+
+	TArray<FVetConditionOp> Ops;
+
+	//Values on the stack after the last instruction and max values on the stack during evaluation
+	int32 StackDepth{0};
+	int32 MaxStackDepth{0};
+};
+
+/**
+ * Base class for native conditions authored inline in interactive configs.
+ * Conditions are compiled into a FVetConditionProgram when the config is loaded.
+ */
+UCLASS(Abstract, EditInlineNew, DefaultToInstanced, CollapseCategories)
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	//Adds the instructions of this condition to the program. Must push exactly one value.
+	virtual void Compile(FVetConditionProgram& OutProgram) const PURE_VIRTUAL(UVetInteractionCondition::Compile, );
+};
+
+//Passes if the interactor owns the tag.
+UCLASS(meta = (DisplayName = "Has Tag"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_HasTag : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	UPROPERTY(EditDefaultsOnly)
+	FGameplayTag Tag;
+
+	//If false parent tags also match (e.g: owning "A.B" matches "A").
+	UPROPERTY(EditDefaultsOnly)
+	bool bExactMatch{false};
+};
+
+//Passes if the interactor owner is within the distance of the interactive owner.
+UCLASS(meta = (DisplayName = "Distance"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_Distance : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0", Units = "cm"))
+	float MaxDistance{200.0f};
+};
+
+//Passes if the interactor owner is facing the interactive owner.
+UCLASS(meta = (DisplayName = "Facing"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_Facing : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	//Max angle between the forward vector of the interactor owner and the direction to the interactive.
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0", ClampMax = "180.0", Units = "deg"))
+	float MaxAngle{45.0f};
+};
+
+//Passes if enough time passed since the last interaction with the interactive ended.
+UCLASS(meta = (DisplayName = "Cooldown"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_Cooldown : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = "0.0", Units = "s"))
+	float Cooldown{1.0f};
+};
+
+//Passes if the interactor and the interactive owners are (or are not) on the same team.
+//Teams are taken from IGenericTeamAgentInterface, pawns use the team of their controller.
+UCLASS(meta = (DisplayName = "Team"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_Team : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	UPROPERTY(EditDefaultsOnly)
+	bool bRequireSameTeam{true};
+};
+
+//Passes if all of the conditions pass.
+UCLASS(meta = (DisplayName = "And"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_And : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	UPROPERTY(EditDefaultsOnly, Instanced)
+	TArray<TObjectPtr<UVetInteractionCondition>> Conditions;
+};
+
+//Passes if any of the conditions pass.
+UCLASS(meta = (DisplayName = "Or"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_Or : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	UPROPERTY(EditDefaultsOnly, Instanced)
+	TArray<TObjectPtr<UVetInteractionCondition>> Conditions;
+};
+
+//Passes if the condition fails.
+UCLASS(meta = (DisplayName = "Not"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_Not : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	UPROPERTY(EditDefaultsOnly, Instanced)
+	TObjectPtr<UVetInteractionCondition> Condition;
+};
+
+/**
+ * Base class for custom native predicates.
+ * Override Evaluate in C++, it is called directly from the compiled program.
+ */
+UCLASS(Abstract)
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionCondition_Native : public UVetInteractionCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Compile(FVetConditionProgram& OutProgram) const override;
+
+	virtual bool Evaluate(const FVetConditionContext& InContext) const PURE_VIRTUAL(UVetInteractionCondition_Native::Evaluate, return false;);
+};
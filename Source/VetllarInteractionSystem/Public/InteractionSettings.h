@@ -0,0 +1,84 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+#pragma once
+
+//Engine
+#include "Engine/DeveloperSettings.h"
+
+//Interaction
+#include "InteractionSettings.generated.h"
+
+/**
+ * Project wide settings for the interaction system.
+ * Found under Project Settings -> Plugins -> Vetllar Interaction.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Vetllar Interaction"))
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+
+	UVetInteractionSettings();
+
+	static const UVetInteractionSettings& Get() { return *GetDefault<UVetInteractionSettings>(); }
+
+	//Size of each cell of the spatial index used to find interactives without running physics traces.
+	//Should be roughly the size of the biggest interaction distance used in the project.
+	UPROPERTY(Config, EditAnywhere, Category = "Spatial Index", meta = (ClampMin = "50.0", Units = "cm"))
+	float SpatialIndexCellSize{500.0f};
+
+	//Updates every interaction component from a single tick owned by the interaction subsystem
+	//instead of a tick function per component.
+	UPROPERTY(Config, EditAnywhere, Category = "Tick Manager")
+	bool bUseInteractionTickManager{false};
+
+	//Time the tick manager is allowed to spend updating interactors each frame.
+	UPROPERTY(Config, EditAnywhere, Category = "Tick Manager", meta = (EditCondition = "bUseInteractionTickManager", ClampMin = "0.0", Units = "ms"))
+	float TickManagerBudgetMs{0.5f};
+
+	//Max time an interactor can wait for an update once it is due, regardless of the budget.
+	UPROPERTY(Config, EditAnywhere, Category = "Tick Manager", meta = (EditCondition = "bUseInteractionTickManager", ClampMin = "0.01", Units = "s"))
+	float TickManagerMaxStaleness{0.25f};
+
+	//Runs the focus sweeps of the interactors updated each frame in parallel, then applies their focus on the game thread.
+	//Only used by sphere traces that don't use the spatial index, async traces or a focus detector.
+	UPROPERTY(Config, EditAnywhere, Category = "Tick Manager", meta = (EditCondition = "bUseInteractionTickManager"))
+	bool bParallelFocusUpdates{false};
+
+	//Batches smaller than this run on the game thread, spreading a few sweeps across workers costs more than it saves.
+	UPROPERTY(Config, EditAnywhere, Category = "Tick Manager", meta = (EditCondition = "bUseInteractionTickManager && bParallelFocusUpdates", ClampMin = "1"))
+	int32 ParallelFocusMinBatchSize{8};
+
+	//Puts the actors owning interactives into net dormancy while nothing about them changes, and wakes them up on any change.
+	//Keeps idle interactives out of the net driver consideration list. Actors with DORM_Never are left alone.
+	//Note that dormancy applies to the whole actor, disable bAllowNetDormancy on interactives of actors replicating other state.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication")
+	bool bManageInteractiveNetDormancy{false};
+
+	//Time an interactive needs to stay unchanged before going dormant.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication", meta = (EditCondition = "bManageInteractiveNetDormancy", ClampMin = "0.0", Units = "s"))
+	float NetDormancyIdleTime{5.0f};
+
+	//Start interaction requests per second the server accepts from each interactor, extra requests are rejected.
+	//Protects the server from clients spamming the input. 0 disables the limit.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication", meta = (ClampMin = "0.0"))
+	float InteractionRequestRate{0.0f};
+
+	//Requests that can be sent back to back before the rate limit kicks in.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication", meta = (EditCondition = "InteractionRequestRate > 0", ClampMin = "1"))
+	int32 InteractionRequestBurst{3};
+
+	//Clients don't repeat a start or stop request while the previous one is waiting for an answer for less than this.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication", meta = (ClampMin = "0.0", Units = "s"))
+	float InteractionRequestCoalesceTime{0.2f};
+
+	//Lightweight interactives closer than this to an interactor are promoted to actors.
+	//Should be bigger than the interaction distance so the actor exists by the time it can be focused on.
+	UPROPERTY(Config, EditAnywhere, Category = "Lightweight Interactives", meta = (ClampMin = "0.0", Units = "cm"))
+	float LightweightPromotionRadius{1000.0f};
+
+	//Time a promoted lightweight interactive stays as an actor once no interactor is around.
+	UPROPERTY(Config, EditAnywhere, Category = "Lightweight Interactives", meta = (ClampMin = "0.0", Units = "s"))
+	float LightweightDemotionDelay{5.0f};
+};
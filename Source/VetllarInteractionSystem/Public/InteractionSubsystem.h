@@ -0,0 +1,319 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+#pragma once
+
+//Engine
+#include "Components/SceneComponent.h"
+#include "Engine/HitResult.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+//Interaction
+#include "InteractiveHandle.h"
+#include "InteractiveTypes.h"
+#include "InteractionSubsystem.generated.h"
+
+class UPrimitiveComponent;
+class UVetInteractionComponent;
+class UVetInteractiveComponent;
+
+//Identifies a lightweight interactive, stale once the interactive is removed.
+//Lightweight interactives are a C++ only API, neither the id nor the functions using it are exposed to blueprints.
+struct FVetLightweightInteractiveId
+{
+	int32 Index{INDEX_NONE};
+	uint32 Generation{0};
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+	bool operator==(const FVetLightweightInteractiveId& InOther) const { return Index == InOther.Index && Generation == InOther.Generation; }
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnLightweightInteractivePromoted, FVetLightweightInteractiveId /*Id*/, AActor& /*PromotedActor*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnLightweightInteractiveDemoted, FVetLightweightInteractiveId /*Id*/);
+
+/**
+ * World subsystem that keeps track of every interactive in the world.
+ * Interactive primitives are stored in a uniform grid so interactors can find focus candidates
+ * with a cheap index lookup instead of running a physics sweep every tick.
+ * When the tick manager is enabled it also updates the focus of every active interactor from a single tick,
+ * round robin and under a per frame time budget.
+ * Timed interactions are completed from a timer wheel keyed on world time instead of ticking each interactive.
+ * It also maps the network handles of interactives to their components on both the server and the clients.
+ *
+ * Lightweight interactives are plain entries with a transform and an actor class, without any actor or component.
+ * The server promotes them to actors when an interactor gets close and demotes them back once nobody is around,
+ * so the interactive interface and components only exist for the few entries near players.
+ * Only the proximity search runs over the entries, in parallel per interactor. They are never focus candidates themselves
+ * and can't be interacted with until promoted, focus and timed completion only run on the promoted actors.
+ */
+UCLASS()
+class VETLLARINTERACTIONSYSTEM_API UVetInteractionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Adds or removes an interactor from the tick manager.
+	void SetInteractorActive(UVetInteractionComponent& InInteractor, bool bInActive);
+
+	//Server only, interactors promote the lightweight interactives around them.
+	void RegisterInteractor(UVetInteractionComponent& InInteractor);
+	void UnregisterInteractor(UVetInteractionComponent& InInteractor);
+
+	//Server only. The actor class needs an interactive component, it is spawned at the transform when promoted.
+	//Clients never see the entry, only the promoted actor, use the promotion events to hide any stand in visuals.
+	FVetLightweightInteractiveId AddLightweightInteractive(const FTransform& InTransform, TSubclassOf<AActor> InActorClass);
+
+	//Destroys the promoted actor too, if any.
+	void RemoveLightweightInteractive(FVetLightweightInteractiveId InId);
+
+	//Disabled lightweight interactives are never promoted. The enabled state and the interactability of every instance
+	//are written back from the actor when demoted, and the instance states are applied again when promoted.
+	void SetLightweightInteractiveEnabled(FVetLightweightInteractiveId InId, bool bInEnabled);
+	bool IsLightweightInteractiveEnabled(FVetLightweightInteractiveId InId) const;
+
+	//Null if the lightweight interactive is not promoted.
+	AActor* GetPromotedActor(FVetLightweightInteractiveId InId) const;
+
+	int32 GetNumLightweightInteractives() const { return LightweightTransforms.Num() - FreeLightweightIndices.Num(); }
+
+	FOnLightweightInteractivePromoted OnLightweightInteractivePromoted;
+	FOnLightweightInteractiveDemoted OnLightweightInteractiveDemoted;
+
+	void RegisterInteractive(UVetInteractiveComponent& InInteractive);
+	void UnregisterInteractive(UVetInteractiveComponent& InInteractive);
+
+	//Returns the interactive component registered by the actor, if any.
+	UVetInteractiveComponent* FindInteractiveComponent(const AActor& InActor) const
+	{
+		const TWeakObjectPtr<UVetInteractiveComponent>* const Interactive = ActorInteractives.Find(&InActor);
+		return Interactive ? Interactive->Get() : nullptr;
+	}
+
+	//Gathers the interactive primitives whose bounds touch the sphere swept from start to end.
+	//Primitives ignoring the trace channel or owned by the ignored actor are skipped.
+	void QueryInteractivePrimitives(const FVector& InStart, const FVector& InEnd, float InRadius, ECollisionChannel InTraceChannel, const AActor* InIgnoredActor, TArray<UPrimitiveComponent*>& OutPrimitives);
+
+	int32 GetNumIndexedPrimitives() const { return Entries.Num(); }
+
+	//Notifies nearby interactors that something about this interactive changed (e.g: its interactability).
+	void MarkInteractiveChanged(UVetInteractiveComponent& InInteractive);
+
+	//Returns a version that changes every time an interactive inside the region is added, removed, moved or marked as changed.
+	uint32 GetRegionVersion(const FBox& InRegion) const;
+
+	//Notifies the interactive once the world time reaches the deadline. An interactive can only have one timer of each type.
+	void ScheduleInteractionTimer(UVetInteractiveComponent& InInteractive, double InDeadline);
+	void CancelInteractionTimer(UVetInteractiveComponent& InInteractive, double InDeadline);
+	void ScheduleDormancyTimer(UVetInteractiveComponent& InInteractive, double InDeadline);
+
+	//Server only, assigns a free handle slot to the interactive. Returns an invalid handle if all slots are taken.
+	FVetInteractiveHandle AllocateInteractiveHandle(UVetInteractiveComponent& InInteractive);
+
+	//Client only, stores the handle the server assigned to the interactive.
+	void AssignInteractiveHandle(UVetInteractiveComponent& InInteractive, const FVetInteractiveHandle& InHandle);
+
+	void ReleaseInteractiveHandle(UVetInteractiveComponent& InInteractive, const FVetInteractiveHandle& InHandle);
+
+	//O(1), returns null if the handle is stale or not known yet.
+	UVetInteractiveComponent* ResolveInteractiveHandle(const FVetInteractiveHandle& InHandle) const;
+
+	//Client only, true if the handle belongs to an interactive that was not received yet.
+	bool IsInteractiveHandlePending(const FVetInteractiveHandle& InHandle) const;
+
+	//Client only, the interactor is asked to resolve its handles again every time a handle is assigned while waiting.
+	void SetWaitingForInteractiveHandles(UVetInteractionComponent& InInteractor, bool bInWaiting);
+
+	//Handle of a primitive owned by a registered interactive. Falls back to an object reference if the handle doesn't
+	//reach clients or the primitive has no index, invalid if the primitive can't be referenced over the network.
+	FVetInteractiveHandle MakePrimitiveHandle(UPrimitiveComponent* InPrimitive) const;
+	UPrimitiveComponent* ResolvePrimitiveHandle(const FVetInteractiveHandle& InHandle) const;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	struct FIndexEntry
+	{
+		TWeakObjectPtr<UVetInteractiveComponent> Interactive;
+		TWeakObjectPtr<UPrimitiveComponent> Primitive;
+		TObjectKey<USceneComponent> PrimitiveKey;
+		FBoxSphereBounds Bounds;
+
+		//Range of cells covered by the bounds
+		FIntVector MinCell;
+		FIntVector MaxCell;
+
+		//True if the bounds are too big to be stored in the grid
+		bool bOversized{false};
+
+		FDelegateHandle TransformUpdatedHandle;
+
+		//Used to avoid returning the same entry twice in a single query
+		uint32 LastQueryStamp{0};
+	};
+
+	struct FManagedInteractor
+	{
+		TWeakObjectPtr<UVetInteractionComponent> Interactor;
+		double LastUpdateTime{0.0};
+	};
+
+	//Snapshot of the sweep of an interactor, taken on the game thread before the parallel stage.
+	struct FBatchedFocusQuery
+	{
+		UVetInteractionComponent* Interactor{nullptr};
+		const AActor* Owner{nullptr};
+		FVector StartLocation{FVector::ZeroVector};
+		FVector EndLocation{FVector::ZeroVector};
+		float Radius{0.0f};
+		ECollisionChannel TraceChannel{ECC_Visibility};
+		TArray<FHitResult> HitResults;
+	};
+
+	enum class ETimerType : uint8
+	{
+		InteractionDeadline,	//A timed interaction completes
+		Dormancy				//An idle interactive goes back to net dormancy
+	};
+
+	struct FInteractionTimer
+	{
+		TWeakObjectPtr<UVetInteractiveComponent> Interactive;
+		double Deadline{0.0};
+		ETimerType Type{ETimerType::InteractionDeadline};
+	};
+
+	struct FHandleSlot
+	{
+		TWeakObjectPtr<UVetInteractiveComponent> Interactive;
+		uint16 Generation{0};
+	};
+
+	struct FCell
+	{
+		TArray<int32> Entries;
+
+		//Last version stamped on this cell, see GetRegionVersion.
+		uint32 Version{0};
+	};
+
+	void AddEntryToCells(int32 InEntryIndex);
+	void RemoveEntryFromCells(int32 InEntryIndex);
+
+	//Stamps a new version on every cell covered by the entry.
+	void TouchEntryCells(int32 InEntryIndex);
+
+	//Removes the cells left empty since the last purge.
+	void PurgeEmptyCells(double InCurrentTime);
+
+	void OnPrimitiveTransformUpdated(USceneComponent* InUpdatedComponent, EUpdateTransformFlags InUpdateTransformFlags, ETeleportType InTeleport);
+
+	void TickManagedInteractors(float InDeltaTime, double InCurrentTime);
+
+	//Runs the batched focus sweeps in parallel and applies their results on the game thread.
+	void RunBatchedFocusQueries();
+	void TickInteractionTimers(double InCurrentTime);
+	void TickLightweightInteractives(double InCurrentTime);
+
+	bool IsValidLightweightId(FVetLightweightInteractiveId InId) const;
+	void PromoteLightweightInteractive(int32 InIndex, double InCurrentTime);
+	void DemoteLightweightInteractive(int32 InIndex);
+
+	//Gameplay destroying a promoted actor removes its lightweight interactive, e.g: a harvested resource.
+	UFUNCTION()
+	void OnPromotedActorDestroyed(AActor* InDestroyedActor);
+
+	FIntVector GetCellCoordinates(const FVector& InLocation) const;
+	int64 GetTimerWheelTick(double InTime) const;
+	void AddTimer(UVetInteractiveComponent& InInteractive, double InDeadline, ETimerType InType);
+
+	TSparseArray<FIndexEntry> Entries;
+
+	//Cells with at least one entry, and the ones emptied since the last purge
+	TMap<FIntVector, FCell> Cells;
+
+	//Cells that became empty, they might have been filled again before the purge
+	TArray<FIntVector> EmptiedCells;
+	double LastEmptyCellPurgeTime{0.0};
+
+	//Entries that cover too many cells, these are tested on every query
+	TArray<int32> OversizedEntries;
+
+	//Shared version of all oversized entries, also part of every region version
+	uint32 OversizedVersion{0};
+
+	//Last version stamped on any cell
+	uint32 LastVersion{0};
+
+	TMap<TObjectKey<UVetInteractiveComponent>, TArray<int32>> InteractiveEntries;
+	TMap<TObjectKey<AActor>, TWeakObjectPtr<UVetInteractiveComponent>> ActorInteractives;
+	TMap<TObjectKey<USceneComponent>, int32> PrimitiveEntries;
+
+	float CellSize{500.0f};
+
+	//Interactors updated by the tick manager. Entries are nulled when deactivated and compacted after the tick.
+	TArray<FManagedInteractor> ManagedInteractors;
+
+	//Index of each active interactor in ManagedInteractors
+	TMap<TWeakObjectPtr<UVetInteractionComponent>, int32> ManagedInteractorIndices;
+
+	//Next interactor to be visited by the tick manager
+	int32 NextManagedInteractor{0};
+
+	//Reused every frame so the hit arrays keep their allocations.
+	TArray<FBatchedFocusQuery> BatchedFocusQueries;
+	int32 NumBatchedFocusQueries{0};
+
+	//Game thread time spent per query by the last batch, charged against the budget of the next ones.
+	double BatchedFocusQueryCost{0.0};
+
+	//Stamped on the entries visited by each query
+	uint32 QueryStamp{0};
+
+	//Slots of the timer wheel, each one holds the timers whose deadline falls in it on any turn of the wheel.
+	TArray<TArray<FInteractionTimer>> TimerWheel;
+
+	//Last wheel tick processed, slots are visited from here up to the current tick.
+	int64 LastTimerWheelTick{0};
+
+	int32 NumInteractionTimers{0};
+
+	//Lightweight interactives, stored as parallel arrays indexed by the id index.
+	TArray<FTransform> LightweightTransforms;
+	TArray<uint16> LightweightClassIndices;
+	TArray<uint32> LightweightGenerations;
+	TArray<uint8> LightweightFlags;
+	TArray<double> LightweightLastNearbyTimes;
+
+	//Sparse, instances that were not available when the lightweight interactive was demoted.
+	TMap<int32, TArray<TPair<int32, EVetInteractability>>> LightweightInstanceStates;
+	TArray<int32> FreeLightweightIndices;
+
+	//Actor classes shared by the lightweight interactives
+	UPROPERTY(Transient)
+	TArray<TSubclassOf<AActor>> LightweightActorClasses;
+
+	//Lightweight interactives are static so they live in their own grid, using the same cell size.
+	TMap<FIntVector, TArray<int32>> LightweightCells;
+
+	TMap<int32, TWeakObjectPtr<AActor>> PromotedActors;
+	TMap<TObjectKey<AActor>, int32> PromotedActorIndices;
+
+	//Interactors around which lightweight interactives are promoted
+	TArray<TWeakObjectPtr<UVetInteractionComponent>> PromotingInteractors;
+
+	//Indexed by the handle index. Clients only fill the slots of the interactives they know about.
+	TArray<FHandleSlot> HandleSlots;
+	TArray<uint16> FreeHandleSlots;
+
+	//Interactors that received handles of interactives this client doesn't know about yet
+	TArray<TWeakObjectPtr<UVetInteractionComponent>> InteractorsWaitingForHandles;
+};
@@ -0,0 +1,72 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+#pragma once
+
+//Engine
+#include "GameplayTagContainer.h"
+
+class UVetInteractionComponent;
+
+/**
+ * Fixed width bitmask of gameplay tags.
+ * Only tags used by interactive tag filters get a bit, assigned the first time a filter using them is compiled.
+ */
+struct VETLLARINTERACTIONSYSTEM_API FVetInteractionTagMask
+{
+	static constexpr int32 NumWords = 2;
+	static constexpr int32 MaxTags = NumWords * 64;
+
+	//Builds the mask of the tags owned by an interactor, parent tags are included so "A.B" matches a filter on "A".
+	//Tags that are not used by any filter are ignored.
+	static FVetInteractionTagMask MakeOwnedMask(const FGameplayTagContainer& InOwnedTags);
+
+	//Builds the mask of the tags used by a filter, assigning bits to tags seen for the first time.
+	//Returns false if the bits ran out, in which case the filter can't be represented as a mask.
+	static bool MakeFilterMask(const FGameplayTagContainer& InFilterTags, FVetInteractionTagMask& OutMask);
+
+	//Changes every time a new tag gets a bit, owned masks built before that might be missing bits.
+	static uint32 GetRegistryVersion();
+
+	FORCEINLINE bool HasAll(const FVetInteractionTagMask& InOther) const
+	{
+		return ((Words[0] & InOther.Words[0]) == InOther.Words[0]) & ((Words[1] & InOther.Words[1]) == InOther.Words[1]);
+	}
+
+	FORCEINLINE bool HasAny(const FVetInteractionTagMask& InOther) const
+	{
+		return ((Words[0] & InOther.Words[0]) | (Words[1] & InOther.Words[1])) != 0;
+	}
+
+	FORCEINLINE bool IsEmpty() const { return (Words[0] | Words[1]) == 0; }
+
+private:
+
+	void SetBit(int32 InBitIndex) { Words[InBitIndex >> 6] |= uint64(1) << (InBitIndex & 63); }
+
+	uint64 Words[NumWords]{0, 0};
+};
+
+/**
+ * Required and blocked tags of an interactive compiled into masks.
+ * The interactor must own all the required tags and none of the blocked tags.
+ */
+struct VETLLARINTERACTIONSYSTEM_API FVetInteractionTagFilter
+{
+	void Compile(const FGameplayTagContainer& InRequiredTags, const FGameplayTagContainer& InBlockedTags);
+
+	//An empty filter always passes
+	bool IsEmpty() const { return RequiredTags.IsEmpty() && BlockedTags.IsEmpty(); }
+
+	bool Passes(const UVetInteractionComponent& InInteractor) const;
+
+private:
+
+	FVetInteractionTagMask RequiredMask;
+	FVetInteractionTagMask BlockedMask;
+
+	//False if the tags didn't fit in the masks, the containers are checked instead.
+	bool bUsesMasks{true};
+
+	FGameplayTagContainer RequiredTags;
+	FGameplayTagContainer BlockedTags;
+};
@@ -6,6 +6,9 @@
 #include "Engine/DataAsset.h"
 
 //Interaction
+#include "InteractionConditions.h"
+#include "InteractionTagMask.h"
+#include "InteractiveTypes.h"
 #include "InteractiveConfig.generated.h"
 
 class UVetInteractionComponent;
@@ -38,6 +41,49 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	UVetInteractiveComponent* GetInteractiveComponent() const;
 
+	//Clears every cached result. Call it when something the results depend on changes
+	//and it is not covered by the declared dependencies.
+	UFUNCTION(BlueprintCallable)
+	void InvalidateCachedResults();
+
+	//Caches the results of the checks and only runs them again when one of the declared dependencies changes.
+	UPROPERTY(EditDefaultsOnly, Category = "Caching")
+	bool bCacheResults{false};
+
+	//Inputs the results of the checks depend on.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "bCacheResults", Bitmask, BitmaskEnum = "/Script/VetllarInteractionSystem.EVetPrerequisiteDependencies"))
+	uint8 Dependencies{static_cast<uint8>(EVetPrerequisiteDependencies::Interactor)};
+
+	//Max amount of results kept, the least recently used result is discarded first.
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "bCacheResults", ClampMin = "1"))
+	int32 MaxCachedResults{16};
+
+private:
+
+	friend class UVetInteractiveComponent;
+
+	struct FCachedResult
+	{
+		//Null if the results do not depend on the interactor
+		TWeakObjectPtr<const UVetInteractionComponent> Interactor;
+
+		//Hash of the rest of the declared dependencies
+		uint32 DependenciesHash{0};
+
+		uint32 LastUseStamp{0};
+
+		TOptional<bool> bCanBeFocusedOn;
+		TOptional<bool> bCanBeInteractedWith;
+	};
+
+	//Wrappers around the virtual checks that go through the cache first.
+	bool CanBeFocusedOn_Internal(const UVetInteractionComponent& InInteractor) const;
+	bool CanBeInteractedWith_Internal(const UVetInteractionComponent& InInteractor) const;
+
+	FCachedResult& FindOrAddCachedResult(const UVetInteractionComponent& InInteractor) const;
+
+	mutable TArray<FCachedResult> CachedResults;
+	mutable uint32 UseStamp{0};
 };
 
 /**
@@ -79,4 +125,58 @@ public:
 	// are met.
 	UPROPERTY(EditDefaultsOnly)
 	TSubclassOf<UVetInteractivePrerequisiteScript> PrerequisitesScript;
+
+	//Tags the interactor must own to focus on or interact with the interactive.
+	//Checked before any other condition or script.
+	UPROPERTY(EditDefaultsOnly)
+	FGameplayTagContainer RequiredTags;
+
+	//Tags that prevent the interactor from focusing on or interacting with the interactive.
+	//Checked before any other condition or script.
+	UPROPERTY(EditDefaultsOnly)
+	FGameplayTagContainer BlockedTags;
+
+	//Native conditions the interactor must pass to focus on the interactive, all of them must pass.
+	//Checked before the prerequisites script.
+	UPROPERTY(EditDefaultsOnly, Instanced)
+	TArray<TObjectPtr<UVetInteractionCondition>> FocusConditions;
+
+	//Native conditions the interactor must pass to interact with the interactive, all of them must pass.
+	//Checked before the prerequisites script.
+	UPROPERTY(EditDefaultsOnly, Instanced)
+	TArray<TObjectPtr<UVetInteractionCondition>> InteractionConditions;
+
+	//Interactors treat the interactive as this much closer when picking what to focus on.
+	//Lets important interactives win over the ones piled around them.
+	UPROPERTY(EditDefaultsOnly, meta = (Units = "cm"))
+	float FocusPriority{0.0f};
+
+	//Cursor picking tests the complex collision of the interactive once its simple collision is hit.
+	//Only worth it for interactives whose simple collision is much bigger than their mesh.
+	UPROPERTY(EditDefaultsOnly)
+	bool bPrecisePicking{false};
+
+	//Changes every time the config is edited, used to invalidate cached results.
+	uint32 GetVersion() const { return Version; }
+
+	const FVetConditionProgram& GetFocusProgram() const;
+	const FVetConditionProgram& GetInteractionProgram() const;
+	const FVetInteractionTagFilter& GetTagFilter() const;
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif //WITH_EDITOR
+
+private:
+
+	void CompileConditions() const;
+
+	uint32 Version{0};
+
+	mutable FVetConditionProgram FocusProgram;
+	mutable FVetConditionProgram InteractionProgram;
+	mutable FVetInteractionTagFilter TagFilter;
+	mutable bool bConditionsCompiled{false};
 };
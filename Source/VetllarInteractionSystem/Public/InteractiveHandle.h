@@ -0,0 +1,98 @@
+// (c) 2023 Leonardo F. Juane - To be used under Boost Software License 1.0
+
+#pragma once
+
+//Engine
+#include "CoreMinimal.h"
+
+//Interaction
+#include "InteractiveHandle.generated.h"
+
+class UPrimitiveComponent;
+
+/**
+ * Compact reference to an interactive primitive, sent over the network instead of an object reference.
+ * The server interaction subsystem assigns a slot to every interactive when it registers, the generation
+ * changes every time a slot is reused so handles of removed interactives fail to resolve.
+ * The primitive index identifies a primitive of the interactive owner, see UVetInteractiveComponent::GetPrimitiveIndex.
+ * The instance index identifies an instance of an instanced static mesh primitive, if the interactive is interacted with per instance.
+ * Interactives whose handle doesn't reach clients (not replicated) and primitives without an index are referenced by object instead,
+ * which only works for net addressable primitives.
+ */
+USTRUCT()
+struct VETLLARINTERACTIONSYSTEM_API FVetInteractiveHandle
+{
+	GENERATED_BODY()
+
+	static constexpr uint8 NoPrimitive = MAX_uint8;
+
+	FVetInteractiveHandle() = default;
+	FVetInteractiveHandle(uint16 InIndex, uint16 InGeneration, uint8 InPrimitiveIndex = NoPrimitive, int32 InInstanceIndex = INDEX_NONE)
+		: Index(InIndex), Generation(InGeneration), PrimitiveIndex(InPrimitiveIndex), InstanceIndex(InInstanceIndex)
+	{}
+
+	//Object reference fallback, see UVetInteractionSubsystem::MakePrimitiveHandle.
+	explicit FVetInteractiveHandle(UPrimitiveComponent* InPrimitive, int32 InInstanceIndex = INDEX_NONE)
+		: InstanceIndex(InInstanceIndex), Primitive(InPrimitive)
+	{}
+
+	//Generation 0 is never assigned, object references are never valid.
+	bool IsValid() const { return Generation != 0; }
+
+	//Null unless this handle is an object reference.
+	UPrimitiveComponent* GetPrimitive() const { return Primitive.Get(); }
+
+	uint16 GetIndex() const { return Index; }
+	uint16 GetGeneration() const { return Generation; }
+	uint8 GetPrimitiveIndex() const { return PrimitiveIndex; }
+	int32 GetInstanceIndex() const { return InstanceIndex; }
+
+	//Handle to another primitive of the same interactive.
+	FVetInteractiveHandle WithPrimitive(uint8 InPrimitiveIndex) const { return FVetInteractiveHandle(Index, Generation, InPrimitiveIndex); }
+
+	//Handle to an instance of the same primitive.
+	FVetInteractiveHandle WithInstance(int32 InInstanceIndex) const
+	{
+		FVetInteractiveHandle InstanceHandle = *this;
+		InstanceHandle.InstanceIndex = InInstanceIndex;
+		return InstanceHandle;
+	}
+
+	bool operator==(const FVetInteractiveHandle& InOther) const
+	{
+		return Index == InOther.Index && Generation == InOther.Generation
+			&& PrimitiveIndex == InOther.PrimitiveIndex && InstanceIndex == InOther.InstanceIndex
+			&& Primitive == InOther.Primitive;
+	}
+
+	bool operator!=(const FVetInteractiveHandle& InOther) const { return !(*this == InOther); }
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+private:
+
+	UPROPERTY()
+	uint16 Index{0};
+
+	UPROPERTY()
+	uint16 Generation{0};
+
+	UPROPERTY()
+	uint8 PrimitiveIndex{NoPrimitive};
+
+	UPROPERTY()
+	int32 InstanceIndex{INDEX_NONE};
+
+	UPROPERTY()
+	TWeakObjectPtr<UPrimitiveComponent> Primitive;
+};
+
+template<>
+struct TStructOpsTypeTraits<FVetInteractiveHandle> : public TStructOpsTypeTraitsBase2<FVetInteractiveHandle>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
@@ -33,8 +33,9 @@ public:
 	
 	// Native --------------------------------------------------------------------------------------------------- //
 
-	virtual void OnBeginFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent) {}
-	virtual void OnEndFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocuedOnComponent) {}
+	//The instance index is INDEX_NONE unless the interactive is interacted with per instance.
+	virtual void OnBeginFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex) {}
+	virtual void OnEndFocusedOn(UVetInteractionComponent& InInteractor, UPrimitiveComponent* InFocuedOnComponent, int32 InFocusedOnInstanceIndex) {}
 
 	virtual EVetInteractability GetInteractabilityState() const { return EVetInteractability::Available; }
 	virtual bool CanBeInteractedWith(UVetInteractionComponent& InInteractor) const { return true; }
@@ -44,10 +45,10 @@ public:
 	//Blueprint functions --------------------------------------------------------------------------------------- //
 
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Begin Focused On"))
-	void K2_OnBeginFocusedOn(UVetInteractionComponent* InInteractor, UPrimitiveComponent* InFocusedOnComponent);
+	void K2_OnBeginFocusedOn(UVetInteractionComponent* InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex);
 
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On End Focused On"))
-	void K2_OnEndFocusedOn(UVetInteractionComponent* InInteractor, UPrimitiveComponent* InFocusedOnComponent);
+	void K2_OnEndFocusedOn(UVetInteractionComponent* InInteractor, UPrimitiveComponent* InFocusedOnComponent, int32 InFocusedOnInstanceIndex);
 
 	//Allows blueprints to state a desired interactability for this actor.
 	//The result will be the less available of the states based on this function and internal results.
@@ -83,12 +84,19 @@ public:
 private:
 
 	friend class UVetInteractionComponent;
+	friend class FVetllarInteractionSystemModule;
 
-	static void BeginFocusedOn_Internal(UVetInteractionComponent& InInteractor, AActor* InInteractive, UPrimitiveComponent* InFocusedOnCompoenent);
-	static void EndFocusedOn_Internal(UVetInteractionComponent& InInteractor, AActor* InInteractive, UPrimitiveComponent* InFocusedOnCompoenent);
+	static void BeginFocusedOn_Internal(UVetInteractionComponent& InInteractor, AActor* InInteractive, UPrimitiveComponent* InFocusedOnCompoenent, int32 InFocusedOnInstanceIndex);
+	static void EndFocusedOn_Internal(UVetInteractionComponent& InInteractor, AActor* InInteractive, UPrimitiveComponent* InFocusedOnCompoenent, int32 InFocusedOnInstanceIndex);
 
 	static EVetInteractability GetInteractabilityState_Internal(AActor* InInteractive);
 	static bool CanBeInteractedWith_Internal(AActor* InInteractive, UVetInteractionComponent* InInteractor);
 	static bool CanBeFocusedOn_Internal(AActor* InInteractive, UVetInteractionComponent* InInteractor);
 	static UVetInteractiveComponent* GetInteractiveComponent_Internal(AActor* InInteractive);
+
+	//Cheaper than UKismetSystemLibrary::DoesImplementInterface, the result is cached per class.
+	static bool ImplementsInterface_Internal(const AActor* InActor);
+
+	//Drops the per class cache, called by the module when classes are reinstanced or a play in editor session ends.
+	static void ResetClassInfos();
 };
\ No newline at end of file
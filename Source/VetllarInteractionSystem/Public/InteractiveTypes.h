@@ -15,4 +15,15 @@ enum class EVetInteractionResult : uint8
 {
 	Success,
 	Cancelled
-};
\ No newline at end of file
+};
+
+//Inputs the result of a prerequisite script depends on.
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EVetPrerequisiteDependencies : uint8
+{
+	None				= 0 UMETA(Hidden),
+	Interactor			= 1 << 0,	//The result is different for each interactor
+	InteractorTags		= 1 << 1,	//The result depends on the gameplay tags owned by the interactor
+	Interactability		= 1 << 2	//The result depends on the interactability of the interactive
+};
+ENUM_CLASS_FLAGS(EVetPrerequisiteDependencies);
\ No newline at end of file
@@ -12,4 +12,13 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+
+	FDelegateHandle WorldCleanupHandle;
+
+#if WITH_EDITOR
+	FDelegateHandle ObjectsReinstancedHandle;
+	FDelegateHandle ReloadCompleteHandle;
+#endif //WITH_EDITOR
 };
@@ -26,6 +26,7 @@ public class VetllarInteractionSystem : ModuleRules
 			new string[]
 			{
 				"Core",
+				"GameplayTags",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -34,9 +35,11 @@ public class VetllarInteractionSystem : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
+				"AIModule",
 				"CoreUObject",
+				"DeveloperSettings",
 				"Engine",
-				"GameplayTags"
+				"NetCore"
 			}
 			);
 		